@@ -0,0 +1,134 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#include "AllocationCounter.h"
+
+#ifndef NDEBUG
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#else
+#include <malloc.h>
+#endif
+
+namespace {
+    thread_local size_t allocationCount{0};
+    std::atomic<size_t> bytesInUse{0};
+    std::atomic<size_t> bytesPeak{0};
+
+    size_t usableSize(void* p, size_t align = 0) {
+#if defined(_MSC_VER)
+        return align ? _aligned_msize(p, align, 0) : _msize(p);
+#elif defined(__APPLE__)
+        (void)align;
+        return malloc_size(p);
+#else
+        (void)align;
+        return malloc_usable_size(p);
+#endif
+    }
+
+    void allocated(void* p, size_t align = 0) {
+        auto size = usableSize(p, align);
+        auto now = bytesInUse.fetch_add(size, std::memory_order_relaxed) + size;
+        auto peak = bytesPeak.load(std::memory_order_relaxed);
+        while (now > peak && !bytesPeak.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {}
+    }
+
+    void released(void* p, size_t align = 0) {
+        if (p)
+            bytesInUse.fetch_sub(usableSize(p, align), std::memory_order_relaxed);
+    }
+
+    void* allocate(size_t size) {
+        ++allocationCount;
+        if (void* p = std::malloc(size ? size : 1)) {
+            allocated(p);
+            return p;
+        }
+        throw std::bad_alloc();
+    }
+
+    void release(void* p) {
+        released(p);
+        std::free(p);
+    }
+
+    void* allocateAligned(size_t size, std::align_val_t al) {
+        ++allocationCount;
+        auto align = static_cast<size_t>(al);
+#ifdef _MSC_VER
+        void* p = _aligned_malloc(size ? size : 1, align);
+#else
+        void* p = std::aligned_alloc(align, (size + align - 1) / align * align);
+#endif
+        if (p) {
+            allocated(p, align);
+            return p;
+        }
+        throw std::bad_alloc();
+    }
+
+    void freeAligned(void* p, std::align_val_t al) {
+        released(p, static_cast<size_t>(al));
+#ifdef _MSC_VER
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+}
+
+void* operator new(size_t size)                                 { return allocate(size); }
+void* operator new[](size_t size)                               { return allocate(size); }
+void* operator new(size_t size, std::align_val_t al)            { return allocateAligned(size, al); }
+void* operator new[](size_t size, std::align_val_t al)          { return allocateAligned(size, al); }
+
+void operator delete(void* p) noexcept                          { release(p); }
+void operator delete[](void* p) noexcept                        { release(p); }
+void operator delete(void* p, size_t) noexcept                  { release(p); }
+void operator delete[](void* p, size_t) noexcept                { release(p); }
+void operator delete(void* p, std::align_val_t al) noexcept     { freeAligned(p, al); }
+void operator delete[](void* p, std::align_val_t al) noexcept   { freeAligned(p, al); }
+void operator delete(void* p, size_t, std::align_val_t al) noexcept     { freeAligned(p, al); }
+void operator delete[](void* p, size_t, std::align_val_t al) noexcept   { freeAligned(p, al); }
+
+
+size_t heapAllocationCount() {
+    return allocationCount;
+}
+
+
+size_t heapBytesInUse() {
+    return bytesInUse.load(std::memory_order_relaxed);
+}
+
+
+size_t heapBytesPeak() {
+    return bytesPeak.load(std::memory_order_relaxed);
+}
+
+#else
+
+size_t heapAllocationCount() {
+    return 0;
+}
+
+
+size_t heapBytesInUse() {
+    return 0;
+}
+
+
+size_t heapBytesPeak() {
+    return 0;
+}
+
+#endif
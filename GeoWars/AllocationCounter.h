@@ -0,0 +1,22 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_ALLOCATIONCOUNTER_H
+#define GEOWARS_ALLOCATIONCOUNTER_H
+
+#include <cstddef>
+
+// Number of general-heap allocations made by the calling thread so far, so worlds
+// running side by side on different threads don't see each other's allocations.
+// Only tracked in debug builds (global operator new is replaced), always 0 with NDEBUG.
+size_t  heapAllocationCount();
+
+// Bytes currently allocated from the general heap by the whole process (usable size of
+// each block, so allocator rounding is included) and the highest value seen.
+// Debug builds only, 0 with NDEBUG.
+size_t  heapBytesInUse();
+size_t  heapBytesPeak();
+
+
+#endif //GEOWARS_ALLOCATIONCOUNTER_H
@@ -0,0 +1,165 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#include "AssetManager.h"
+#include "Log.h"
+
+
+AssetManager::AssetManager(unsigned atlasSize, unsigned maxAtlased)
+        : m_atlasSize(atlasSize)
+        , m_maxAtlased(maxAtlased) {}
+
+
+AssetManager::~AssetManager() {
+    if (!m_thread.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    m_thread.join();
+}
+
+
+void AssetManager::loaderLoop() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+            if (m_stop)
+                return;
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+        job();
+    }
+}
+
+
+void AssetManager::enqueue(std::function<void()> job) {
+    // the loader thread starts with the first request, a headless game never has one
+    if (!m_thread.joinable())
+        m_thread = std::thread(&AssetManager::loaderLoop, this);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push_back(std::move(job));
+    }
+    m_wake.notify_one();
+}
+
+
+AssetHandle<sf::Font> AssetManager::loadFont(const std::string &id, const std::string &path) {
+    if (auto cached = m_fonts[id].lock())
+        return cached;
+
+    auto asset = std::make_shared<Asset<sf::Font>>();
+    asset->m_path = path;
+    m_fonts[id] = asset;
+
+    // fonts need no GPU work up front (glyph pages are made on first use), so the
+    // loader thread finishes them on its own
+    enqueue([this, asset] {
+        bool ok = asset->m_value.loadFromFile(asset->m_path);
+        asset->m_state.store(ok ? Asset<sf::Font>::Ready : Asset<sf::Font>::Failed, std::memory_order_release);
+        if (!ok)
+            Log::error(LogCategory::Assets, "Failed to load font {}", asset->m_path);
+    });
+    return asset;
+}
+
+
+AssetHandle<TextureRegion> AssetManager::loadTexture(const std::string &id, const std::string &path) {
+    if (auto cached = m_textures[id].lock())
+        return cached;
+
+    auto asset = std::make_shared<Asset<TextureRegion>>();
+    asset->m_path = path;
+    m_textures[id] = asset;
+
+    // decode here, upload in pump()
+    enqueue([this, asset] {
+        PendingImage pending{asset, {}};
+        bool ok = pending.image.loadFromFile(asset->m_path);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (ok) {
+            m_decoded.push_back(std::move(pending));
+        }
+        else {
+            Log::error(LogCategory::Assets, "Failed to load texture {}", asset->m_path);
+            asset->m_state.store(Asset<TextureRegion>::Failed, std::memory_order_release);
+        }
+    });
+    return asset;
+}
+
+
+bool AssetManager::packIntoAtlas(PendingImage &pending) {
+    auto size = pending.image.getSize();
+    if (size.x > m_maxAtlased || size.y > m_maxAtlased || size.x > m_atlasSize || size.y > m_atlasSize)
+        return false;
+
+    // try the current shelf of the newest page, then a new shelf, then a new page
+    AtlasPage* page = m_pages.empty() ? nullptr : m_pages.back().get();
+    if (page && page->cursorX + size.x > m_atlasSize) {
+        page->shelfY += page->shelfHeight;
+        page->cursorX = 0;
+        page->shelfHeight = 0;
+    }
+    if (!page || page->shelfY + size.y > m_atlasSize) {
+        m_pages.push_back(std::make_unique<AtlasPage>());
+        page = m_pages.back().get();
+        if (!page->texture.create(m_atlasSize, m_atlasSize)) {
+            m_pages.pop_back();
+            return false;
+        }
+    }
+
+    page->texture.update(pending.image, page->cursorX, page->shelfY);
+
+    auto& region = pending.asset->m_value;
+    region.texture = &page->texture;
+    region.rect = sf::IntRect(static_cast<int>(page->cursorX), static_cast<int>(page->shelfY),
+                              static_cast<int>(size.x), static_cast<int>(size.y));
+    page->cursorX += size.x;
+    page->shelfHeight = std::max(page->shelfHeight, size.y);
+    return true;
+}
+
+
+void AssetManager::upload(PendingImage &pending) {
+    auto& asset = *pending.asset;
+    bool ok = packIntoAtlas(pending);
+    if (!ok) {
+        auto texture = std::make_unique<sf::Texture>();
+        ok = texture->loadFromImage(pending.image);
+        if (ok) {
+            auto size = pending.image.getSize();
+            asset.m_value.rect = sf::IntRect(0, 0, static_cast<int>(size.x), static_cast<int>(size.y));
+            asset.m_value.texture = texture.get();
+            asset.m_value.own = std::move(texture);
+        }
+    }
+    if (!ok)
+        Log::error(LogCategory::Assets, "Failed to upload texture {}", asset.m_path);
+    asset.m_state.store(ok ? Asset<TextureRegion>::Ready : Asset<TextureRegion>::Failed, std::memory_order_release);
+}
+
+
+size_t AssetManager::pump() {
+    std::vector<PendingImage> decoded;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_decoded.empty())
+            return 0;
+        decoded.swap(m_decoded);
+    }
+
+    for (auto& pending : decoded)
+        upload(pending);
+    return decoded.size();
+}
+
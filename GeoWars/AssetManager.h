@@ -0,0 +1,119 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_ASSETMANAGER_H
+#define GEOWARS_ASSETMANAGER_H
+
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+
+// A texture as the game sees it: either a whole texture of its own or a rectangle in
+// one of the shared atlas pages. Draw it with sprite.setTexture(*texture) and
+// sprite.setTextureRect(rect).
+struct TextureRegion
+{
+    const sf::Texture*              texture{nullptr};
+    sf::IntRect                     rect;
+    std::unique_ptr<sf::Texture>    own;        // set for textures too big for the atlas
+};
+
+
+// Shared state behind a handle. The loader thread fills value in and publishes it with
+// a release store, so isReady() on any thread means value can be read.
+template<typename T>
+class Asset
+{
+private:
+    friend class AssetManager;
+    enum State { Loading, Ready, Failed };
+
+    std::atomic<int>    m_state{Loading};
+    std::string         m_path;
+    T                   m_value;
+
+public:
+    bool                isReady() const     { return m_state.load(std::memory_order_acquire) == Ready; }
+    bool                isFailed() const    { return m_state.load(std::memory_order_acquire) == Failed; }
+    bool                isDone() const      { return m_state.load(std::memory_order_acquire) != Loading; }
+    const T&            get() const         { return m_value; }
+    const std::string&  getPath() const     { return m_path; }
+};
+
+template<typename T>
+using AssetHandle = std::shared_ptr<const Asset<T>>;
+
+
+// Loads fonts and textures on a background thread and caches them by id.
+// Handles are reference counted: an asset stays cached while anyone holds a handle
+// and asking for the same id again returns the same one. Files are read and decoded on
+// the loader thread; anything that needs the GPU (texture upload, atlas packing)
+// happens in pump(), which the game calls once per frame on the render thread.
+// Images up to maxAtlased pixels on each side share atlas pages instead of getting a
+// texture each.
+class AssetManager
+{
+private:
+    struct PendingImage
+    {
+        std::shared_ptr<Asset<TextureRegion>>   asset;
+        sf::Image                               image;
+    };
+
+    // shelf packer: images go left to right on the current shelf, a new shelf starts
+    // below the tallest image on it when the row is full
+    struct AtlasPage
+    {
+        sf::Texture     texture;
+        unsigned        cursorX{0};
+        unsigned        shelfY{0};
+        unsigned        shelfHeight{0};
+    };
+
+    unsigned                                                        m_atlasSize;
+    unsigned                                                        m_maxAtlased;
+    std::vector<std::unique_ptr<AtlasPage>>                         m_pages;
+
+    std::unordered_map<std::string, std::weak_ptr<Asset<sf::Font>>>         m_fonts;
+    std::unordered_map<std::string, std::weak_ptr<Asset<TextureRegion>>>    m_textures;
+
+    // loader thread
+    std::thread                                 m_thread;
+    std::mutex                                  m_mutex;
+    std::condition_variable                     m_wake;
+    std::deque<std::function<void()>>           m_jobs;
+    std::vector<PendingImage>                   m_decoded;      // waiting for pump()
+    bool                                        m_stop{false};
+
+    void                    loaderLoop();
+    void                    enqueue(std::function<void()> job);
+    void                    upload(PendingImage& pending);
+    bool                    packIntoAtlas(PendingImage& pending);
+
+public:
+    explicit AssetManager(unsigned atlasSize = 1024, unsigned maxAtlased = 256);
+    ~AssetManager();
+
+    AssetManager(const AssetManager&) = delete;
+    AssetManager& operator=(const AssetManager&) = delete;
+
+    // start loading (or return the cached handle), never blocks
+    AssetHandle<sf::Font>           loadFont(const std::string& id, const std::string& path);
+    AssetHandle<TextureRegion>      loadTexture(const std::string& id, const std::string& path);
+
+    // main thread, once per frame: uploads decoded images, returns how many finished
+    size_t                          pump();
+};
+
+
+#endif //GEOWARS_ASSETMANAGER_H
@@ -0,0 +1,86 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#include "BatchRunner.h"
+#include "Game.h"
+#include "Log.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <latch>
+#include <memory>
+#include <thread>
+
+
+BatchRunner::BatchRunner(const std::string &configPath, size_t instances, uint64_t ticks)
+        : m_configPath(configPath), m_instances(std::max<size_t>(instances, 1)), m_ticks(ticks) {}
+
+
+void BatchRunner::run() {
+    using Clock = std::chrono::steady_clock;
+
+    m_results.assign(m_instances, Result{});
+
+    // every world is built on its own thread, the clock starts once all are ready
+    std::latch ready(static_cast<std::ptrdiff_t>(m_instances) + 1);
+    std::vector<std::thread> workers;
+    workers.reserve(m_instances);
+
+    for (size_t i = 0; i < m_instances; ++i) {
+        workers.emplace_back([this, i, &ready]() {
+            auto game = std::make_unique<Game>(m_configPath, true);
+            game->setSeed(i + 1);
+            ready.arrive_and_wait();
+
+            auto start = Clock::now();
+            game->runHeadless(m_ticks);
+            auto end = Clock::now();
+
+            auto& r = m_results[i];
+            r.instance = i;
+            r.ticks = game->getTick();
+            r.seconds = std::chrono::duration<double>(end - start).count();
+            r.score = game->getScore();
+            r.entities = game->getEntityCount();
+            r.memory = game->getMemory();
+        });
+    }
+
+    ready.arrive_and_wait();
+    auto start = Clock::now();
+    for (auto& t : workers)
+        t.join();
+    double wall = std::chrono::duration<double>(Clock::now() - start).count();
+
+    // the report goes straight to stdout, after whatever the worlds logged
+    Logger::get().flush();
+    uint64_t totalTicks{0};
+    std::cout << "instance      ticks    seconds   ticks/sec   entities      score   mem peak (KB)\n";
+    for (auto& r : m_results) {
+        totalTicks += r.ticks;
+        std::cout << std::setw(8) << r.instance
+                  << std::setw(11) << r.ticks
+                  << std::setw(11) << std::fixed << std::setprecision(3) << r.seconds
+                  << std::setw(12) << std::setprecision(0) << (r.seconds > 0 ? r.ticks / r.seconds : 0.0)
+                  << std::setw(11) << r.entities
+                  << std::setw(11) << r.score
+                  << std::setw(16) << r.memory.getTotalPeak() / 1024 << "\n";
+    }
+    std::cout << "total: " << m_instances << " worlds, " << totalTicks << " ticks in "
+              << std::setprecision(3) << wall << " s = "
+              << std::setprecision(0) << (wall > 0 ? totalTicks / wall : 0.0) << " ticks/sec\n";
+
+    // the worlds run the same config, one breakdown is representative (heap figures are
+    // for the whole process)
+    if (!m_results.empty()) {
+        std::cout << "\ninstance 0 at the end of the run:\n";
+        m_results.front().memory.print(std::cout);
+    }
+}
+
+
+const std::vector<BatchRunner::Result> &BatchRunner::getResults() const {
+    return m_results;
+}
@@ -0,0 +1,44 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_BATCHRUNNER_H
+#define GEOWARS_BATCHRUNNER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MemoryStats.h"
+
+
+// Hosts K independent headless Game worlds in one process, one per thread, runs each
+// for a fixed number of ticks and reports the aggregated throughput.
+class BatchRunner
+{
+public:
+    struct Result
+    {
+        size_t          instance{0};
+        uint64_t        ticks{0};
+        double          seconds{0.0};
+        int             score{0};
+        size_t          entities{0};
+        MemoryTracker   memory;
+    };
+
+private:
+    std::string             m_configPath;
+    size_t                  m_instances;
+    uint64_t                m_ticks;
+    std::vector<Result>     m_results;
+
+public:
+    BatchRunner(const std::string& configPath, size_t instances, uint64_t ticks);
+
+    // blocks until every world has finished, then prints the report
+    void                        run();
+    const std::vector<Result>&  getResults() const;
+};
+
+
+#endif //GEOWARS_BATCHRUNNER_H
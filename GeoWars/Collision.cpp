@@ -0,0 +1,134 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#include "Collision.h"
+#include "Entity.h"
+#include "JobSystem.h"
+#include "FrameArena.h"
+#include "HierarchicalGrid.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+
+int CollisionMatrix::defineLayer(const std::string &name) {
+    int layer = findLayer(name);
+    if (layer >= 0)
+        return layer;
+    if (m_layerNames.size() >= MAX_LAYERS)
+        return -1;
+    m_layerNames.push_back(name);
+    return static_cast<int>(m_layerNames.size() - 1);
+}
+
+
+int CollisionMatrix::findLayer(const std::string &name) const {
+    auto it = std::find(m_layerNames.begin(), m_layerNames.end(), name);
+    return it == m_layerNames.end() ? -1 : static_cast<int>(it - m_layerNames.begin());
+}
+
+
+void CollisionMatrix::assignTag(const std::string &tag, int layer) {
+    m_tagLayers[tag] = layer;
+}
+
+
+void CollisionMatrix::addToMask(int layer, int other) {
+    m_masks[layer] |= LayerMask(1) << other;
+}
+
+
+int CollisionMatrix::getLayerForTag(const std::string &tag) const {
+    auto it = m_tagLayers.find(tag);
+    return it == m_tagLayers.end() ? -1 : it->second;
+}
+
+
+LayerMask CollisionMatrix::getMask(int layer) const {
+    return m_masks[layer];
+}
+
+
+const std::map<std::string, int> &CollisionMatrix::getTagLayers() const {
+    return m_tagLayers;
+}
+
+
+bool CollisionMatrix::empty() const {
+    return m_tagLayers.empty();
+}
+
+
+void gridBroadPhase(HierarchicalGrid &grid, const std::pmr::vector<ColliderProxy> &proxies,
+                    std::pmr::vector<CandidatePair> &pairs) {
+    pairs.clear();
+
+    // only layers that appear in some mask can be hit, the rest never enter the grid
+    LayerMask targets{0};
+    for (auto& p : proxies)
+        targets |= p.mask;
+
+    grid.clear();
+    for (std::uint32_t i = 0; i < proxies.size(); ++i) {
+        if (proxies[i].bit & targets)
+            grid.insert(i, proxies[i].pos, proxies[i].radius);
+    }
+    grid.build();
+
+    for (std::uint32_t i = 0; i < proxies.size(); ++i) {
+        const auto& pi = proxies[i];
+        if (pi.mask == 0)
+            continue;
+        grid.queryCircle(pi.pos, pi.radius, [&](std::uint32_t j) {
+            const auto& pj = proxies[j];
+            if (j == i || !(pi.mask & pj.bit))
+                return;
+            // when both masks accept the pair the lower index reports it, as the a side
+            if ((pj.mask & pi.bit) && j < i)
+                return;
+            float reach = pi.radius + pj.radius;
+            if (std::abs(pi.pos.x - pj.pos.x) <= reach && std::abs(pi.pos.y - pj.pos.y) <= reach)
+                pairs.push_back({i, j});
+        });
+    }
+}
+
+
+void narrowPhase(JobSystem &jobs, FrameArena &arena,
+                 const std::pmr::vector<ColliderProxy> &proxies,
+                 const std::pmr::vector<CandidatePair> &pairs,
+                 std::pmr::vector<std::uint32_t> &contacts) {
+    using ContactBuffer = std::pmr::vector<std::uint32_t>;
+    static const size_t GRAIN{256};
+
+    // one buffer per worker slot, each backed by that slot's arena so growing it
+    // from a worker thread never touches another thread's allocator
+    size_t slots = jobs.getWorkerCount();
+    std::pmr::polymorphic_allocator<> alloc(arena.resource(0));
+    ContactBuffer* buffers = alloc.allocate_object<ContactBuffer>(slots);
+    for (size_t i = 0; i < slots; ++i)
+        std::construct_at(buffers + i, arena.resource(i));
+
+    jobs.parallelFor(pairs.size(), GRAIN, [&](size_t begin, size_t end, size_t slot) {
+        auto& out = buffers[slot];
+        for (size_t i = begin; i < end; ++i) {
+            const auto& a = proxies[pairs[i].a];
+            const auto& b = proxies[pairs[i].b];
+            sf::Vector2f d = a.pos - b.pos;
+            float r = a.radius + b.radius;
+            if (d.x * d.x + d.y * d.y <= r * r)
+                out.push_back(static_cast<std::uint32_t>(i));
+        }
+    });
+
+    // deterministic merge: each buffer is sorted already (chunks are handed out in
+    // increasing order per slot), so concatenate and sort by pair index
+    contacts.clear();
+    for (size_t i = 0; i < slots; ++i)
+        contacts.insert(contacts.end(), buffers[i].begin(), buffers[i].end());
+    std::sort(contacts.begin(), contacts.end());
+
+    std::destroy_n(buffers, slots);
+    alloc.deallocate_object(buffers, slots);
+}
@@ -0,0 +1,91 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_COLLISION_H
+#define GEOWARS_COLLISION_H
+
+#include <SFML/System.hpp>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+// forward declarations
+class Entity;
+class JobSystem;
+class FrameArena;
+class HierarchicalGrid;
+
+using LayerMask = std::uint32_t;
+
+
+// Collision layers and the mask matrix, declared in config.txt:
+//   CollisionLayer <name> <tag> [tag...]     assigns tags to a layer
+//   CollisionMask  <name> <layer> [layer...] layers that <name> tests against
+// A pair is only considered if (mask of one side & bit of the other) != 0.
+class CollisionMatrix
+{
+public:
+    static const size_t MAX_LAYERS{32};
+
+private:
+    std::vector<std::string>                m_layerNames;
+    std::array<LayerMask, MAX_LAYERS>       m_masks{};
+    std::map<std::string, int>              m_tagLayers;
+
+public:
+    // returns the layer index, defining it if needed (-1 if out of layers)
+    int                                     defineLayer(const std::string& name);
+    int                                     findLayer(const std::string& name) const;
+    void                                    assignTag(const std::string& tag, int layer);
+    void                                    addToMask(int layer, int other);
+
+    int                                     getLayerForTag(const std::string& tag) const;
+    LayerMask                               getMask(int layer) const;
+    const std::map<std::string, int>&       getTagLayers() const;
+    bool                                    empty() const;
+};
+
+// flat copy of what the collision passes need, so the hot loops never chase entity pointers
+struct ColliderProxy
+{
+    Entity*         entity{nullptr};
+    sf::Vector2f    pos{0.f, 0.f};
+    float           radius{0.f};
+    LayerMask       bit{0};         // 1 << layer
+    LayerMask       mask{0};        // layers this collider tests against
+
+    ColliderProxy() = default;
+    ColliderProxy(Entity* e, sf::Vector2f p, float r, int layer, LayerMask m)
+            : entity(e), pos(p), radius(r), bit(LayerMask(1) << layer), mask(m) {}
+};
+
+// indices into the proxy array, a is the side whose mask accepted the pair
+struct CandidatePair
+{
+    std::uint32_t   a;
+    std::uint32_t   b;
+};
+
+// Broad phase: every proxy some mask can hit goes into the grid at the level that fits
+// its radius, then each proxy with a mask queries it with its own circle, so a bullet
+// touches a few cells and the special weapon only the cells under it. Fills pairs with
+// every pair whose bounding boxes overlap and whose layers pass the mask test, grouped
+// by querying proxy in proxy order, so the order is deterministic.
+void    gridBroadPhase(HierarchicalGrid& grid, const std::pmr::vector<ColliderProxy>& proxies,
+                       std::pmr::vector<CandidatePair>& pairs);
+
+// Narrow phase: circle tests over the candidate pairs, split across the job system.
+// Each slot writes hits into its own buffer taken from its frame arena slot; contacts
+// receives the merged pair indices in ascending order so resolution is independent of
+// how the work was scheduled.
+void    narrowPhase(JobSystem& jobs, FrameArena& arena,
+                    const std::pmr::vector<ColliderProxy>& proxies,
+                    const std::pmr::vector<CandidatePair>& pairs,
+                    std::pmr::vector<std::uint32_t>& contacts);
+
+
+#endif //GEOWARS_COLLISION_H
@@ -0,0 +1,61 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#include "CommandBuffer.h"
+#include "EntityManager.h"
+#include "Entity.h"
+
+
+void CommandBuffer::createEntity(const std::string &tag, Init init) {
+    m_commands.push_back({CmdType::Create, nullptr, tag, std::move(init)});
+}
+
+
+void CommandBuffer::destroy(sPtrEntt e) {
+    m_commands.push_back({CmdType::Destroy, std::move(e), {}, {}});
+}
+
+
+void CommandBuffer::modify(sPtrEntt e, Init fn) {
+    m_commands.push_back({CmdType::Modify, std::move(e), {}, std::move(fn)});
+}
+
+
+bool CommandBuffer::empty() const {
+    return m_commands.empty();
+}
+
+
+size_t CommandBuffer::size() const {
+    return m_commands.size();
+}
+
+
+void CommandBuffer::playback(EntityManager &manager) {
+    for (auto& cmd : m_commands) {
+        switch (cmd.type) {
+            case CmdType::Create: {
+                auto e = manager.addEntity(cmd.tag);
+                if (cmd.fn)
+                    cmd.fn(*e);
+                break;
+            }
+            case CmdType::Destroy:
+                cmd.target->destroy();
+                break;
+
+            case CmdType::Modify:
+                // changes recorded against an entity destroyed earlier in the same tick are dropped
+                if (cmd.target->isActive())
+                    cmd.fn(*cmd.target);
+                break;
+        }
+    }
+    clear();
+}
+
+
+void CommandBuffer::clear() {
+    m_commands.clear();
+}
@@ -0,0 +1,70 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_COMMANDBUFFER_H
+#define GEOWARS_COMMANDBUFFER_H
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <memory>
+#include "Entity.h"
+
+// forward declarations
+class EntityManager;
+
+using sPtrEntt  = std::shared_ptr<Entity>;
+
+// Records structural changes (create, destroy, add/remove component) so they can be
+// issued from a parallel system without touching the entity storage.
+// Each worker thread owns exactly one buffer, so recording needs no locks; the
+// EntityManager plays every buffer back in slot order at the start of update().
+class CommandBuffer
+{
+public:
+    using Init = std::function<void(Entity&)>;
+
+private:
+    enum class CmdType { Create, Destroy, Modify };
+
+    struct Command {
+        CmdType         type;
+        sPtrEntt        target;     // Destroy / Modify
+        std::string     tag;        // Create
+        Init            fn;         // Create (optional) / Modify
+    };
+
+    std::vector<Command>        m_commands;
+
+public:
+    CommandBuffer() = default;
+
+    // entity is created at playback, init (if any) runs on it before it becomes visible
+    void                        createEntity(const std::string& tag, Init init = {});
+    void                        destroy(sPtrEntt e);
+
+
+    template<typename T, typename... TArgs>
+    inline void addComponent(sPtrEntt e, TArgs... mArgs) {
+        modify(std::move(e), [=](Entity& entt) { entt.template addComponent<T>(mArgs...); });
+    }
+
+
+    template<typename T>
+    inline void removeComponent(sPtrEntt e) {
+        modify(std::move(e), [](Entity& entt) { entt.template removeComponent<T>(); });
+    }
+
+
+    void                        modify(sPtrEntt e, Init fn);
+
+    bool                        empty() const;
+    size_t                      size() const;
+
+    void                        playback(EntityManager& manager);
+    void                        clear();
+};
+
+
+#endif //GEOWARS_COMMANDBUFFER_H
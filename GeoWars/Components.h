@@ -21,11 +21,15 @@ struct CShape : public Component
 {
     sf::CircleShape circle;
 
+    // as authored, circle may be drawn with less detail when quality is reduced
+    size_t          points{ 30 };
+    float           thickness{ 0.f };
+
     CShape() = default;
 
 
     CShape(float r, size_t points, const sf::Color& fill, const sf::Color& outline=sf::Color::Black, float thickness = 5.f)
-            : circle(r, points)
+            : circle(r, points), points(points), thickness(thickness)
     {
         circle.setFillColor(fill);
         circle.setOutlineColor(outline);
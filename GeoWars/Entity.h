@@ -48,7 +48,7 @@ public:
 
 
     template<typename T>
-    inline bool removeComponent() const {
+    inline bool removeComponent() {
         return getComponent<T>().has = false;
     }
 
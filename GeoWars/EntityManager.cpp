@@ -7,7 +7,7 @@
 #include <algorithm>
 
 
-EntityManager::EntityManager() : m_totalEntities(0)  {}
+EntityManager::EntityManager() : m_totalEntities(0), m_commandBuffers(1)  {}
 
 
 std::shared_ptr<Entity> EntityManager::addEntity(const std::string &tag) {
@@ -21,14 +21,84 @@ std::shared_ptr<Entity> EntityManager::addEntity(const std::string &tag) {
 }
 
 
+void EntityManager::reset(size_t nextId) {
+    m_entities.clear();
+    // keep the tag buckets (and their capacity), looking up a missing tag inserts into the map
+    for (auto& [_, entityVec] : m_entityMap)
+        entityVec.clear();
+    m_EntitiesToAdd.clear();
+    for (auto& cb : m_commandBuffers)
+        cb.clear();
+    m_totalEntities = nextId;
+    m_lastUpdateChanged = true;
+}
+
+
+std::shared_ptr<Entity> EntityManager::restoreEntity(size_t id, const std::string &tag) {
+    auto e = std::shared_ptr<Entity>(new Entity(id, tag));
+    m_entities.push_back(e);
+    m_entityMap[tag].push_back(e);
+    return e;
+}
+
+
+const EntityVec &EntityManager::getPendingEntities() const {
+    return m_EntitiesToAdd;
+}
+
+
+size_t EntityManager::getNextId() const {
+    return m_totalEntities;
+}
+
+
 EntityVec &EntityManager::getEntities(const std::string &tag) {
     return m_entityMap[tag];
 }
 
 
+const EntityMap &EntityManager::getEntityMap() const {
+    return m_entityMap;
+}
+
+
+void EntityManager::setWorkerCount(size_t n) {
+    // flush anything recorded under the old layout before resizing
+    playback();
+    m_commandBuffers.resize(std::max<size_t>(n, 1));
+}
+
+
+size_t EntityManager::getWorkerCount() const {
+    return m_commandBuffers.size();
+}
+
+
+CommandBuffer &EntityManager::getCommandBuffer(size_t slot) {
+    return m_commandBuffers[slot];
+}
+
+
+void EntityManager::playback() {
+    // always in slot order so the result (including ids of created entities) does not
+    // depend on thread timing
+    for (auto& cb : m_commandBuffers)
+        cb.playback(*this);
+}
+
+
 void EntityManager::update() {
+    // Sync point: apply deferred structural changes
+    playback();
+
+    size_t before = m_entities.size();
+    m_lastUpdateChanged = !m_EntitiesToAdd.empty();
+
     // Remove dead entities
     removeDeadEntities(m_entities);
+    m_lastUpdateChanged |= (m_entities.size() != before);
+    m_removedCount += before - m_entities.size();
+    m_addedCount += m_EntitiesToAdd.size();
     for (auto& [_, entityVec] : m_entityMap)
         removeDeadEntities(entityVec);
 
@@ -43,6 +113,26 @@ void EntityManager::update() {
 }
 
 
+std::uint64_t EntityManager::getAddedCount() const {
+    return m_addedCount;
+}
+
+
+std::uint64_t EntityManager::getRemovedCount() const {
+    return m_removedCount;
+}
+
+
+bool EntityManager::isSteady() const {
+    if (m_lastUpdateChanged || !m_EntitiesToAdd.empty())
+        return false;
+    for (auto& cb : m_commandBuffers)
+        if (!cb.empty())
+            return false;
+    return std::all_of(m_entities.begin(), m_entities.end(), [](auto& e) { return e->isActive(); });
+}
+
+
 EntityVec &EntityManager::getEntities() {
     return m_entities;
 }
@@ -6,10 +6,12 @@
 #define GEOWARS_ENTITYMANAGER_H
 
 
+#include <cstdint>
 #include <map>
 #include <vector>
 #include <string>
 #include <memory>
+#include "CommandBuffer.h"
 
 //forward declare
 class Entity;
@@ -26,6 +28,10 @@ private:
     EntityMap	                m_entityMap;
     size_t                      m_totalEntities{0};
     EntityVec                   m_EntitiesToAdd;
+    std::vector<CommandBuffer>  m_commandBuffers;
+    bool                        m_lastUpdateChanged{false};
+    std::uint64_t               m_addedCount{0};        // by update(), restored entities are not counted
+    std::uint64_t               m_removedCount{0};
 
     void		                removeDeadEntities(EntityVec& v);
 
@@ -33,10 +39,35 @@ public:
     EntityManager();
 
     sPtrEntt                    addEntity(const std::string& tag);
+
+    // snapshot support: drop every entity (live, pending and recorded), then recreate
+    // entities with their original ids, they are live immediately
+    void                        reset(size_t nextId);
+    sPtrEntt                    restoreEntity(size_t id, const std::string& tag);
+    size_t                      getNextId() const;
     EntityVec&                  getEntities();
     EntityVec&                  getEntities(const std::string& tag);
+    const EntityMap&            getEntityMap() const;
+    const EntityVec&            getPendingEntities() const;    // added, live from the next update()
+
+    // one command buffer per worker slot, played back in slot order by update()
+    void                        setWorkerCount(size_t n);
+    size_t                      getWorkerCount() const;
+    CommandBuffer&              getCommandBuffer(size_t slot = 0);
+
+    // plays every buffer back now, for a system that wants its changes applied before
+    // the next system runs; created entities still wait for update()
+    void                        playback();
 
     void                        update();
+
+    // running totals of entities added to and removed from the live list
+    std::uint64_t               getAddedCount() const;
+    std::uint64_t               getRemovedCount() const;
+
+    // true if the last update() neither added nor removed entities and nothing is
+    // queued, destroyed or recorded for the next one (walks all entities, debug use)
+    bool                        isSteady() const;
 };
 
 
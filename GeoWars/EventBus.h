@@ -0,0 +1,87 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_EVENTBUS_H
+#define GEOWARS_EVENTBUS_H
+
+#include <algorithm>
+#include <functional>
+#include <span>
+#include <tuple>
+#include <vector>
+
+
+// Typed event queues with batched delivery. Producers append to a contiguous queue per
+// event type (one per worker slot, so parallel systems can emit without locks) and
+// dispatch() hands each subscriber the whole batch at once, types in the order they are
+// listed, slots in slot order within a type, so delivery is deterministic.
+// Queues keep their capacity, after warm-up emitting does not allocate.
+template<typename... Events>
+class EventBus
+{
+private:
+    template<typename E>
+    struct Queue
+    {
+        std::vector<std::vector<E>>                         slots{1};
+        std::vector<std::function<void(std::span<const E>)>> handlers;
+    };
+
+    std::tuple<Queue<Events>...>    m_queues;
+
+    template<typename E>
+    Queue<E>&                       queue() { return std::get<Queue<E>>(m_queues); }
+
+    template<typename E>
+    void deliver() {
+        auto& q = queue<E>();
+        auto& batch = q.slots.front();
+
+        // other slots are appended behind slot 0, in slot order
+        for (size_t s = 1; s < q.slots.size(); ++s) {
+            batch.insert(batch.end(), q.slots[s].begin(), q.slots[s].end());
+            q.slots[s].clear();
+        }
+        if (batch.empty())
+            return;
+
+        // a handler may emit more events of this type, they wait for the next dispatch
+        std::vector<E> delivering;
+        delivering.swap(batch);
+        for (auto& handler : q.handlers)
+            handler(std::span<const E>(delivering));
+        delivering.clear();
+        if (batch.empty())
+            batch.swap(delivering);     // keep the capacity
+    }
+
+public:
+    // one queue per worker slot for every event type
+    void setSlotCount(size_t slots) {
+        (queue<Events>().slots.resize(std::max<size_t>(slots, 1)), ...);
+    }
+
+    template<typename E>
+    void emit(const E& event, size_t slot = 0) {
+        queue<E>().slots[slot].push_back(event);
+    }
+
+    template<typename E>
+    void subscribe(std::function<void(std::span<const E>)> handler) {
+        queue<E>().handlers.push_back(std::move(handler));
+    }
+
+    // every queued event goes to its subscribers, types in declaration order
+    void dispatch() {
+        (deliver<Events>(), ...);
+    }
+
+    // drop everything queued, e.g. when a snapshot replaces the world
+    void clear() {
+        (std::for_each(queue<Events>().slots.begin(), queue<Events>().slots.end(), [](auto& s) { s.clear(); }), ...);
+    }
+};
+
+
+#endif //GEOWARS_EVENTBUS_H
@@ -0,0 +1,77 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#include "FrameArena.h"
+#include <algorithm>
+
+
+void *FrameArena::OverflowResource::do_allocate(size_t bytes, size_t align) {
+    ++allocations;
+    this->bytes += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, align);
+}
+
+
+void FrameArena::OverflowResource::do_deallocate(void *p, size_t bytes, size_t align) {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+}
+
+
+bool FrameArena::OverflowResource::do_is_equal(const std::pmr::memory_resource &other) const noexcept {
+    return this == &other;
+}
+
+
+FrameArena::FrameArena(size_t bytesPerSlot, size_t slots) {
+    m_slots.resize(std::max<size_t>(slots, 1));
+    for (auto& slot : m_slots) {
+        slot = std::make_unique<Slot>();
+        slot->capacity = bytesPerSlot;
+        slot->buffer = std::make_unique<std::byte[]>(bytesPerSlot);
+        slot->resource.emplace(slot->buffer.get(), slot->capacity, &slot->overflow);
+    }
+}
+
+
+size_t FrameArena::getSlotCount() const {
+    return m_slots.size();
+}
+
+
+std::pmr::memory_resource *FrameArena::resource(size_t slot) {
+    return &*m_slots[slot]->resource;
+}
+
+
+size_t FrameArena::getOverflowAllocations(size_t slot) const {
+    return m_slots[slot]->overflowTotal + m_slots[slot]->overflow.allocations;
+}
+
+
+void FrameArena::reset() {
+    for (auto& slot : m_slots) {
+        slot->resource->release();
+
+        if (slot->overflow.allocations > 0) {
+            // double until this tick's demand would have fit
+            size_t needed = slot->capacity + slot->overflow.bytes;
+            while (slot->capacity < needed)
+                slot->capacity *= 2;
+            slot->buffer = std::make_unique<std::byte[]>(slot->capacity);
+
+            slot->overflowTotal += slot->overflow.allocations;
+            slot->overflow.allocations = 0;
+            slot->overflow.bytes = 0;
+        }
+        slot->resource.emplace(slot->buffer.get(), slot->capacity, &slot->overflow);
+    }
+}
+
+
+MemoryFootprint FrameArena::getFootprint() const {
+    size_t bytes{0};
+    for (auto& slot : m_slots)
+        bytes += sizeof(Slot) + slot->capacity;
+    return MemoryFootprint{bytes, bytes};
+}
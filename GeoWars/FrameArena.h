@@ -0,0 +1,68 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_FRAMEARENA_H
+#define GEOWARS_FRAMEARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <vector>
+#include "MemoryStats.h"
+
+
+// Per-tick scratch memory for systems. Each worker slot gets its own monotonic
+// buffer so parallel systems can allocate without locking; everything handed out
+// during a tick is released at once by reset() at the end of the tick.
+//
+// If a slot runs out of space the request falls through to the heap and the slot is
+// grown at the next reset, so a too-small initial size only costs a few ticks.
+class FrameArena
+{
+private:
+    // forwards to the heap and remembers that the arena overflowed
+    class OverflowResource : public std::pmr::memory_resource
+    {
+    public:
+        size_t          allocations{0};
+        size_t          bytes{0};
+
+    private:
+        void*           do_allocate(size_t bytes, size_t align) override;
+        void            do_deallocate(void* p, size_t bytes, size_t align) override;
+        bool            do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+    };
+
+    struct Slot
+    {
+        std::unique_ptr<std::byte[]>                        buffer;
+        size_t                                              capacity{0};
+        OverflowResource                                    overflow;
+        size_t                                              overflowTotal{0};  // earlier ticks
+        std::optional<std::pmr::monotonic_buffer_resource>  resource;
+    };
+
+    std::vector<std::unique_ptr<Slot>>  m_slots;
+
+public:
+    // slots is the worker count and fixed for the arena's lifetime
+    FrameArena(size_t bytesPerSlot = 256 * 1024, size_t slots = 1);
+
+    size_t                      getSlotCount() const;
+    std::pmr::memory_resource*  resource(size_t slot = 0);
+
+    // heap allocations the arena itself made because this slot overflowed (all ticks);
+    // they land on the heap counter of the thread that used the slot, not the caller's
+    size_t                      getOverflowAllocations(size_t slot) const;
+
+    // slot buffers, all of it counts as used: it is scratch reserved on purpose
+    MemoryFootprint             getFootprint() const;
+
+    // release everything allocated this tick, grow any slot that overflowed
+    void                        reset();
+};
+
+
+#endif //GEOWARS_FRAMEARENA_H
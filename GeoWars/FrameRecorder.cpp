@@ -0,0 +1,255 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#include "FrameRecorder.h"
+#include "Log.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+
+
+FrameRecorder::FrameRecorder() {
+    configure(m_format, 30.f, 8, m_directory);
+}
+
+
+FrameRecorder::~FrameRecorder() {
+    if (m_recording)
+        stop();
+    if (!m_thread.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    m_thread.join();
+}
+
+
+void FrameRecorder::configure(Format format, float fps, size_t buffers, const std::string &directory) {
+    if (m_recording)
+        return;
+    readBack(0);
+    waitIdle();
+
+    m_format = format;
+    m_interval = sf::seconds(1.f / std::max(fps, 1.f));
+    m_directory = directory;
+
+    // the ring has to hold the frames waiting for readback plus at least one for the worker
+    m_slots.clear();
+    m_slots.resize(std::max(buffers, m_latency + 2));
+    for (auto& slot : m_slots)
+        slot = std::make_unique<Slot>();
+    m_next = 0;
+}
+
+
+bool FrameRecorder::start(const std::string &prefix) {
+    if (m_recording)
+        return true;
+    readBack(0);        // a screenshot in flight still uses the old prefix
+    waitIdle();
+
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+    m_prefix = prefix;
+    if (m_format == Raw) {
+        auto path = m_directory + "/" + m_prefix + "frames.rgba";
+        m_raw.open(path, std::ios::binary | std::ios::trunc);
+        if (!m_raw) {
+            Log::error(LogCategory::Capture, "Cannot record to {}", path);
+            return false;
+        }
+    }
+
+    m_recording = true;
+    m_sinceCapture = sf::Time::Zero;
+    m_size = sf::Vector2u();
+    m_frame = 0;
+    m_startStats = getStats();
+    Log::info(LogCategory::Capture, "Recording to {}/{}", m_directory, m_prefix);
+    return true;
+}
+
+
+void FrameRecorder::stop() {
+    if (!m_recording)
+        return;
+
+    // whatever is still on the GPU is read back now, the recording is over so a stall is fine
+    readBack(0);
+    waitIdle();
+    m_recording = false;
+    m_recordDue = false;
+
+    auto stats = getStats();
+    Log::info(LogCategory::Capture, "Recorded {} frames, {} dropped",
+              stats.written - m_startStats.written, stats.dropped - m_startStats.dropped);
+    if (m_format == Raw) {
+        m_raw.close();
+        auto base = m_directory + "/" + m_prefix;
+        Log::info(LogCategory::Capture, "  ffmpeg -f rawvideo -pixel_format rgba -video_size {}x{} -framerate {} -i {}frames.rgba {}frames.mp4",
+                  m_size.x, m_size.y, 1.f / m_interval.asSeconds(), base, base);
+    }
+}
+
+
+bool FrameRecorder::isRecording() const {
+    return m_recording;
+}
+
+
+void FrameRecorder::screenshot() {
+    m_screenshotPending = true;
+}
+
+
+bool FrameRecorder::due(sf::Time dt) {
+    m_recordDue = false;
+    if (m_recording) {
+        m_sinceCapture += dt;
+        if (m_sinceCapture >= m_interval) {
+            // after a long frame the recording skips ahead rather than capturing a burst
+            m_sinceCapture = m_sinceCapture >= m_interval + m_interval ? sf::Time::Zero : m_sinceCapture - m_interval;
+            m_recordDue = true;
+        }
+    }
+    return m_recordDue || m_screenshotPending;
+}
+
+
+void FrameRecorder::capture(const sf::Window &window) {
+    if (auto* slot = acquire(window.getSize())) {
+        slot->texture.update(window);
+        readBack(m_recording ? m_latency : 0);
+    }
+}
+
+
+void FrameRecorder::capture(const sf::Texture &texture) {
+    if (auto* slot = acquire(texture.getSize())) {
+        slot->texture.update(texture);
+        readBack(m_recording ? m_latency : 0);
+    }
+}
+
+
+FrameRecorder::Stats FrameRecorder::getStats() const {
+    return Stats{m_captured, m_written.load(std::memory_order_relaxed), m_dropped};
+}
+
+
+FrameRecorder::Slot *FrameRecorder::acquire(sf::Vector2u size) {
+    bool record = m_recordDue;
+    bool shot = m_screenshotPending;
+    m_recordDue = false;
+
+    // a raw file is one stream of same-sized frames, a resized window can't join it
+    if (record && m_format == Raw) {
+        if (m_size == sf::Vector2u())
+            m_size = size;
+        if (size != m_size) {
+            ++m_dropped;
+            record = false;
+        }
+    }
+    if (!record && !shot)
+        return nullptr;
+
+    // the oldest buffer is still with the worker: drop the frame, a screenshot waits for the next one
+    auto& slot = *m_slots[m_next];
+    if (slot.state.load(std::memory_order_acquire) != Free) {
+        if (record)
+            ++m_dropped;
+        return nullptr;
+    }
+
+    if (!m_thread.joinable())
+        m_thread = std::thread(&FrameRecorder::workerLoop, this);
+    if (slot.texture.getSize() != size)
+        slot.texture.create(size.x, size.y);
+
+    m_screenshotPending = false;
+    slot.frame = record ? ++m_frame : 0;
+    slot.screenshot = shot ? ++m_screenshots : 0;
+    slot.state.store(Copied, std::memory_order_relaxed);
+    if (record)
+        ++m_captured;
+
+    m_copied.push_back(&slot);
+    m_next = (m_next + 1) % m_slots.size();
+    return &slot;
+}
+
+
+void FrameRecorder::readBack(size_t keep) {
+    while (m_copied.size() > keep) {
+        auto* slot = m_copied.front();
+        m_copied.pop_front();
+        slot->image = slot->texture.copyToImage();
+        slot->state.store(Queued, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.push_back(slot);
+        }
+        m_wake.notify_one();
+    }
+}
+
+
+void FrameRecorder::waitIdle() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_queue.empty() && !m_busy; });
+}
+
+
+void FrameRecorder::workerLoop() {
+    while (true) {
+        Slot* slot;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_busy = false;
+            if (m_queue.empty())
+                m_idle.notify_all();
+            m_wake.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+            if (m_queue.empty())
+                return;
+            slot = m_queue.front();
+            m_queue.pop_front();
+            m_busy = true;
+        }
+        encode(*slot);
+        slot->state.store(Free, std::memory_order_release);
+    }
+}
+
+
+void FrameRecorder::encode(Slot &slot) {
+    // m_directory, m_prefix and m_raw only change while the worker is idle
+    char name[32];
+    if (slot.screenshot != 0) {
+        std::snprintf(name, sizeof(name), "screenshot_%04llu.png", static_cast<unsigned long long>(slot.screenshot));
+        std::error_code error;
+        std::filesystem::create_directories(m_directory, error);
+        if (slot.image.saveToFile(m_directory + "/" + m_prefix + name))
+            Log::info(LogCategory::Capture, "Saved {}/{}{}", m_directory, m_prefix, name);
+    }
+    if (slot.frame == 0)
+        return;
+
+    bool ok;
+    if (m_format == Png) {
+        std::snprintf(name, sizeof(name), "frame_%06llu.png", static_cast<unsigned long long>(slot.frame));
+        ok = slot.image.saveToFile(m_directory + "/" + m_prefix + name);
+    }
+    else {
+        auto size = slot.image.getSize();
+        m_raw.write(reinterpret_cast<const char*>(slot.image.getPixelsPtr()), std::streamsize(size.x) * size.y * 4);
+        ok = m_raw.good();
+    }
+    if (ok)
+        m_written.fetch_add(1, std::memory_order_relaxed);
+}
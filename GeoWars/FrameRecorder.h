@@ -0,0 +1,120 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_FRAMERECORDER_H
+#define GEOWARS_FRAMERECORDER_H
+
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+// Records frames without making the render thread wait for the GPU or the disk.
+// capture() copies the frame into the next texture of a ring, which stays on the GPU,
+// and reads back the texture it filled `latency` captures earlier, by then the GPU has
+// long finished with it. The pixels go to a worker thread that writes one PNG per
+// frame or appends them to a single raw RGBA file. When every buffer is still queued
+// for the worker the frame is dropped and counted, capture never blocks.
+class FrameRecorder
+{
+public:
+    enum Format { Png, Raw };
+
+    // totals over every recording
+    struct Stats
+    {
+        uint64_t    captured{0};    // copied into the ring
+        uint64_t    written{0};     // encoded and on disk
+        uint64_t    dropped{0};     // no free buffer, or a different size than the recording
+    };
+
+private:
+    enum SlotState { Free, Copied, Queued };
+
+    struct Slot
+    {
+        sf::Texture         texture;
+        sf::Image           image;
+        uint64_t            frame{0};         // number in the recording, 0 = not recorded
+        uint64_t            screenshot{0};    // number of the screenshot, 0 = none
+        std::atomic<int>    state{Free};      // Free is stored by the worker, read by the render thread
+    };
+
+    Format                              m_format{Png};
+    sf::Time                            m_interval{sf::seconds(1.f / 30.f)};
+    size_t                              m_latency{2};       // captures between copy and readback
+    std::string                         m_directory{"capture"};
+    std::vector<std::unique_ptr<Slot>>  m_slots;
+
+    // render thread
+    bool                                m_recording{false};
+    bool                                m_screenshotPending{false};
+    bool                                m_recordDue{false};
+    std::string                         m_prefix;
+    sf::Time                            m_sinceCapture{sf::Time::Zero};
+    size_t                              m_next{0};          // next slot in the ring
+    std::deque<Slot*>                   m_copied;           // on the GPU, oldest first
+    sf::Vector2u                        m_size;             // of the recording, raw frames can't change it
+    uint64_t                            m_frame{0};
+    uint64_t                            m_screenshots{0};
+    uint64_t                            m_captured{0};
+    uint64_t                            m_dropped{0};
+    Stats                               m_startStats;       // totals when this recording started
+
+    // worker thread
+    std::thread                         m_thread;
+    std::mutex                          m_mutex;
+    std::condition_variable             m_wake;
+    std::condition_variable             m_idle;
+    std::deque<Slot*>                   m_queue;
+    bool                                m_busy{false};
+    bool                                m_stop{false};
+    std::ofstream                       m_raw;              // written by the worker only while recording
+    std::atomic<uint64_t>               m_written{0};
+
+    void                    workerLoop();
+    void                    encode(Slot& slot);
+    Slot*                   acquire(sf::Vector2u size);
+    void                    readBack(size_t keep);
+    void                    waitIdle();
+
+public:
+    FrameRecorder();
+    ~FrameRecorder();
+
+    FrameRecorder(const FrameRecorder&) = delete;
+    FrameRecorder& operator=(const FrameRecorder&) = delete;
+
+    // frames per second and ring size, only while not recording
+    void                    configure(Format format, float fps, size_t buffers, const std::string& directory);
+
+    // file names start with prefix, so several recorders can share a directory
+    bool                    start(const std::string& prefix = "");
+    // reads back what is still on the GPU and waits for the worker to write it
+    void                    stop();
+    bool                    isRecording() const;
+
+    // the next frame is also saved as a PNG of its own, recording or not
+    void                    screenshot();
+
+    // advances the capture clock, true when this frame should be captured
+    bool                    due(sf::Time dt);
+
+    // copy the frame just drawn: a window before display(), or a render texture after it
+    void                    capture(const sf::Window& window);
+    void                    capture(const sf::Texture& texture);
+
+    Stats                   getStats() const;
+};
+
+
+#endif //GEOWARS_FRAMERECORDER_H
@@ -10,9 +10,31 @@
 #include <SFML/Graphics.hpp>
 #include <vector>
 #include <memory>
+#include <random>
 
 #include "Entity.h"
 #include "EntityManager.h"
+#include "Collision.h"
+#include "JobSystem.h"
+#include "FrameArena.h"
+#include "Hud.h"
+#include "SpatialGrid.h"
+#include "HierarchicalGrid.h"
+#include "StateStream.h"
+#include "Rng.h"
+#include "SpawnScheduler.h"
+#include "SpawnBudget.h"
+#include "QualityController.h"
+#include "ParticleSystem.h"
+#include "Swarm.h"
+#include "AssetManager.h"
+#include "Metrics.h"
+#include "MemoryStats.h"
+#include "GameEvents.h"
+#include "SpscQueue.h"
+#include "FrameRecorder.h"
+#include "RewindBuffer.h"
+#include "TargetIndex.h"
 
 using uint = unsigned int;
 
@@ -28,15 +50,40 @@ struct BulletConfig { int  FR, FG, FB, OR, OG, OB, OT, V, L; float SR, CR, S; };
 // Special Weapon
 struct SpecialConfig { int  FR, FG, FB, OR, OG, OB, OT, V, L; float SR, CR, S; };
 
+// Swarming enemies, the steering parameters live in SwarmParams
+struct SwarmConfig { int  FR, FG, FB, OR, OG, OB, V; float SR, CR, OT; };
+
 
 class Game {
 private:
 	const static sf::Time TIME_PER_FRAME;
 
 	sf::Vector2u                m_windowSize{ 1280,768 };
+	sf::Vector2f                m_worldSize{ 0.f, 0.f };   // 0 = same as the window
 	sf::RenderWindow            m_window;
+	sf::View                    m_worldView;               // camera, follows the player
+	uint64_t                    m_tick{ 0 };
 	EntityManager               m_entityManager;
-	sf::Font                    m_font;
+	size_t                      m_threadCount{ 0 };  // 0 = one per hardware thread
+	std::unique_ptr<JobSystem>  m_jobs;
+	size_t                      m_frameArenaBytes{ 256 * 1024 };
+	std::unique_ptr<FrameArena> m_frameArena;  // per-tick scratch, reset at the end of sUpdate
+	// fonts and textures load in the background while the window comes up
+	AssetManager                m_assets;
+	std::string                 m_fontPath;
+	std::string                 m_scoreFontPath;
+	std::string                 m_backgroundPath;
+	AssetHandle<sf::Font>       m_font;
+	AssetHandle<sf::Font>       m_scoreFont;
+	AssetHandle<TextureRegion>  m_background;
+	sf::Sprite                  m_backgroundSprite;
+	bool                        m_assetsApplied{ false };
+	sf::Clock                   m_startupClock;        // construction to the first frame with every asset
+	uint64_t                    m_seed{ 0 };
+	Rng                         m_rng;                 // master stream, split per system
+	Rng                         m_spawnRng;
+	Rng                         m_particleRng;         // cosmetic only, not saved in snapshots
+	bool                        m_headless{ false };   // no window, input or rendering
 	sPtrEntt                    m_player{ nullptr };
 	int                         m_score{ 0 };
 
@@ -48,24 +95,175 @@ private:
 	SpecialConfig			   m_specialConfig;
 	int 					   m_specialWeaponCount{ 0 }; // number of special weapons
 
+	// Swarm enemies, neighbours are found through their own grid (cell = neighbour radius)
+	SwarmConfig                 m_swarmConfig{ 255, 120, 0, 255, 255, 255, 3, 10.f, 10.f, 1.f };
+	SwarmParams                 m_swarmParams;
+	SpatialGrid                 m_swarmGrid;
+
+	// scripted waves from the config, SpawnWave/SwarmWave <start> <count> <interval> [repeat] in seconds
+	struct SpawnWave { sf::Time start, interval, repeat; int count; bool swarm; };
+	std::vector<SpawnWave>      m_spawnWaves;
+	sf::Time                    m_nextSpawnAt{ sf::Time::Zero };   // scheduler time of the next ambient enemy
+
+	// spawn distributions, built once from the config and world size
+	struct SpawnDistributions {
+		std::uniform_real_distribution<float>   x, y, speed, dir;
+		std::uniform_int_distribution<>         points, color;
+		std::exponential_distribution<float>    interval;
+	}                           m_spawnDist;
+	std::string                 m_snapshotPath{ "snapshot.gws" };   // F5 saves, F9 loads
+
+	// delta state stream for spectators on localhost, 0 = off
+	unsigned short              m_streamPort{ 0 };
+	StateServer                 m_stateServer;
+
+	// owns the spawn coroutines (ambient arrivals and scripted waves)
+	SpawnScheduler              m_spawnScheduler;
+
+	// per-tick spawn budget and population caps, every spawn except the player goes through it
+	SpawnBudget                 m_spawnBudget;
+
+	// gameplay side effects (score, fragments, explosions) run as batched event handlers
+	GameEventBus                m_events;
+
+	// gameplay input, stamped when polled and applied once per tick by sApplyInput();
+	// latency is measured up to the first frame displayed after the tick that applied it
+	struct InputEvent {
+		enum Action : std::uint8_t { Up, Down, Left, Right, Fire, Special };
+		Action                  action;
+		bool                    pressed;
+		sf::Vector2f            target;     // world position, Fire and Special
+		sf::Time                polled;     // on m_inputClock
+	};
+	SpscQueue<InputEvent, 256>  m_inputQueue;
+	sf::Clock                   m_inputClock;
+	std::vector<sf::Time>       m_inputsApplied;           // waiting for the frame that shows them
+	size_t                      m_inputsDropped{ 0 };
+	sf::Time                    m_inputLatencySum{ sf::Time::Zero };
+	unsigned int                m_inputLatencyCount{ 0 };
+
+	// Prometheus metrics, served on localhost:<port>/metrics and/or rewritten to a file
+	// every interval (port 0 / file "-" = off); the registry is fed even when nothing exports it
+	unsigned short              m_metricsPort{ 0 };
+	std::string                 m_metricsFile;
+	sf::Time                    m_metricsInterval{ sf::seconds(10.f) };
+	MetricsRegistry             m_metrics;
+	MetricsExporter             m_metricsExporter;
+	// memory by component, tag and subsystem, sampled once per second (M shows it)
+	MemoryTracker               m_memory;
+	bool                        m_showMemory{ false };
+	// frame capture, F12 starts/stops recording and F11 saves a screenshot; a headless
+	// world records from an offscreen texture when the config starts recording
+	FrameRecorder               m_recorder;
+	bool                        m_recordOnStart{ false };
+	sf::RenderTexture           m_offscreen;
+	// the last seconds of world state, captured every tick; R pauses and scrubs through
+	// them, play resumes from whichever tick is shown (not kept by headless worlds)
+	float                       m_rewindSeconds{ 10.f };
+	size_t                      m_rewindMegabytes{ 64 };
+	size_t                      m_rewindKeyframe{ 60 };
+	RewindBuffer                m_rewind;
+	bool                        m_rewinding{ false };
+	size_t                      m_rewindPos{ 0 };
+
+	struct GameMetrics {
+		Histogram*              tick;
+		Histogram*              spawner;
+		Histogram*              lifespan;
+		Histogram*              swarm;
+		Histogram*              targeting;
+		Histogram*              movement;
+		Histogram*              collision;
+		Histogram*              particles;
+		Histogram*              stream;
+		Histogram*              events;
+		Histogram*              rewind;
+		Histogram*              frame;
+		Histogram*              inputApply;
+		Histogram*              inputDisplay;
+		Counter*                ticks;
+		Counter*                created;
+		Counter*                destroyed;
+		Counter*                admitted;
+		Counter*                deferred;
+		Counter*                dropped;
+		Counter*                inputDropped;
+		Counter*                scoreEarned;
+		Counter*                enemiesKilled;
+		Counter*                playerHits;
+		Counter*                bulletsExpired;
+		Counter*                framesCaptured;
+		Counter*                framesWritten;
+		Counter*                framesDropped;
+		Counter*                scrapes;
+		Gauge*                  score;
+		Gauge*                  particlesAlive;
+		Gauge*                  quality;
+	}                           m_gameMetrics{};
+
 
 	bool                        m_isRunning{ true };
 	bool                        m_isPaused{ false };
 	bool                        m_drawBB{ false };
 
 	// stats
-	sf::Text                    m_statisticsText;
+	Hud                         m_hud;
 	sf::Time                    m_statisticsUpdateTime{ sf::Time::Zero };
 	unsigned int                m_statisticsNumFrames{ 0 };
 
+	// hit sparks and explosion debris, outside the entity manager (0 = off)
+	size_t                      m_particleCapacity{ 20000 };
+	ParticleSystem              m_particles;
+
+	// render quality drops when frames run over budget and comes back with headroom
+	QualityController           m_quality;
+
+	// collision layers/masks from config
+	CollisionMatrix             m_collisionMatrix;
+	// broad phase, cells double in size per level so every collider size has a level that fits
+	float                       m_collisionCellSize{ 64.f };
+	size_t                      m_collisionLevels{ 4 };
+	HierarchicalGrid            m_collisionGrid;
+
+	// live enemy positions for nearest-target queries, rebuilt every tick: homing bullets
+	// turn towards the nearest enemy in range, auto-aim sends a shot at the enemy nearest
+	// the cursor (H and T toggle them)
+	float                       m_targetCellSize{ 128.f };
+	TargetIndex                 m_targets;
+	bool                        m_homing{ false };
+	float                       m_homingTurnRate{ 360.f };   // degrees per second
+	float                       m_homingRange{ 400.f };
+	bool                        m_autoAim{ false };
+	float                       m_autoAimRadius{ 120.f };    // around the cursor
+
+	// render culling and off-screen simulation level of detail
+	float                       m_gridCellSize{ 128.f };
+	SpatialGrid                 m_renderGrid;
+	std::vector<std::uint32_t>  m_visible;                 // indices into getEntities()
+	float                       m_simLodMargin{ 300.f };   // distance outside the view before LOD kicks in
+	uint64_t                    m_simLodInterval{ 4 };     // off-screen entities move every N ticks
+
+	// render scratch, kept so nothing is rebuilt every frame
+	int                         m_shownScore{ 0 };
+	sf::CircleShape             m_crShape;
+
 
 	// Systems
 	void                        sMovement(sf::Time dt);
 	void                        sUserInput();
+	void                        sApplyInput();
 	void                        sLifespan(sf::Time dt);
-	void                        sRender();
+	void                        sRender(sf::Time dt);
 	void                        sEnemySpawner(sf::Time dt);
+	SpawnTask                   ambientSpawner(sf::Time firstDelay);
+	SpawnTask                   waveSpawner(SpawnWave wave, sf::Time elapsed);
+	void                        startSpawners(sf::Time ambientDelay);
+	void                        sSwarm(sf::Time dt);
+	void                        sTargeting(sf::Time dt);
 	void                        sCollision();
+	void                        resolveContacts(const std::pmr::vector<ColliderProxy>& colliders,
+												const std::pmr::vector<CandidatePair>& pairs,
+												const std::pmr::vector<std::uint32_t>& contacts);
 	void                        sUpdate(sf::Time dt);
 
 
@@ -73,20 +271,54 @@ private:
 	void                        adjustPlayerPosition();
 	void                        spawnPlayer();
 	void                        spawnEnemy();
-	void                        spawnSmallEnemies(sPtrEntt e);
-	void                        spawnBullet(sf::Vector2f dir);
-	void                        spawnSpecialWeapon(sf::Vector2f mPos2);
+	void                        spawnSwarmEnemy(sf::Vector2f pos);
+	void                        buildSpawnDistributions();
+	void                        spawnSmallEnemies(const Entity& e);
+	void                        spawnExplosion(const Entity& e, size_t count, float speed);
+	void                        spawnBullet(sf::Vector2f dir, sf::Time polled);
+	sf::Vector2f                autoAim(sf::Vector2f target) const;
+	void                        spawnSpecialWeapon(sf::Vector2f mPos2, sf::Time polled);
 	void                        updateStatistics(sf::Time dt);
 	void                        loadConfigFromFile(const std::string& path);
+	void                        applyLoadedAssets();
+	void                        registerMetrics();
+	void                        queueInput(InputEvent::Action action, bool pressed, sf::Vector2f target = {});
+	void                        inputApplied(sf::Time polled);
+	void                        recordInputLatency();
+	void                        subscribeEvents();
+	void                        collectMetrics();
+	void                        sampleMemory();
+	void                        captureRewind();
+	void                        toggleRewind();
+	bool                        scrubRewind(sf::Keyboard::Key key);
+	void                        rewindTo(size_t index);
+	void                        resumeWorld(sf::Time spawnCountdown);
 	sf::FloatRect               getViewBounds();
+	sf::FloatRect               getWorldBounds() const;
+	void                        updateCamera();
+	void                        cullToView();
 	void                        keepObjecsInBounds();
-	void                        drawCR();
+	void                        drawWorld(sf::RenderTarget& target);
+	void                        drawCR(sf::RenderTarget& target);
 
 public:
 
-	Game(const std::string& path);
+	Game(const std::string& path, bool headless = false);
 	void run();
 
+	// headless simulation, used by the batch runner
+	void runHeadless(uint64_t ticks);
+	void setSeed(uint64_t seed);
+	uint64_t getTick() const;
+	int getScore() const;
+	size_t getEntityCount();
+	EntityVec& getEntities();
+	const MemoryTracker& getMemory() const;
+
+	// binary world snapshots (entities, components, rng, spawn timer and score)
+	bool saveSnapshot(const std::string& path);
+	bool loadSnapshot(const std::string& path);
+
 
 };
 
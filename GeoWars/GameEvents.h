@@ -0,0 +1,45 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_GAMEEVENTS_H
+#define GEOWARS_GAMEEVENTS_H
+
+#include <cstdint>
+#include "EventBus.h"
+
+class Entity;
+
+
+// Gameplay events. Entity pointers stay valid until the end of the tick they were
+// emitted in: destroyed entities are only released by the next EntityManager::update(),
+// which runs after dispatch.
+
+// an enemy was shot, hit by the special weapon, or rammed the player
+struct EnemyKilled
+{
+    enum Cause : std::uint8_t { Bullet, SpecialWeapon, Player };
+
+    const Entity*   enemy;
+    const Entity*   by;
+    Cause           cause;
+};
+
+// the player collided with an enemy and is respawned next tick
+struct PlayerHit
+{
+    const Entity*   player;
+    const Entity*   enemy;
+};
+
+// a bullet ran out of lifespan, it is destroyed before collision runs that tick
+struct BulletExpired
+{
+    const Entity*   bullet;
+};
+
+
+using GameEventBus = EventBus<EnemyKilled, PlayerHit, BulletExpired>;
+
+
+#endif //GEOWARS_GAMEEVENTS_H
@@ -0,0 +1,71 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#include "HierarchicalGrid.h"
+#include <algorithm>
+
+
+void HierarchicalGrid::reset(const sf::FloatRect &bounds, float baseCellSize, size_t levels) {
+    m_baseCellSize = std::max(baseCellSize, 1.f);
+    m_levels.resize(std::max<size_t>(levels, 1));
+    float cellSize = m_baseCellSize;
+    for (auto& level : m_levels) {
+        level.reset(bounds, cellSize);
+        cellSize *= 2.f;
+    }
+}
+
+
+void HierarchicalGrid::clear() {
+    for (auto& level : m_levels)
+        level.clear();
+}
+
+
+size_t HierarchicalGrid::levelFor(float radius) const {
+    size_t level = 0;
+    float cellSize = m_baseCellSize;
+    while (cellSize < 2.f * radius && level + 1 < m_levels.size()) {
+        cellSize *= 2.f;
+        ++level;
+    }
+    return level;
+}
+
+
+void HierarchicalGrid::insert(std::uint32_t id, sf::Vector2f pos, float radius) {
+    m_levels[levelFor(radius)].insert(id, pos, radius);
+}
+
+
+void HierarchicalGrid::build() {
+    for (auto& level : m_levels)
+        level.build();
+}
+
+
+size_t HierarchicalGrid::size() const {
+    size_t n{0};
+    for (auto& level : m_levels)
+        n += level.size();
+    return n;
+}
+
+
+size_t HierarchicalGrid::getLevelCount() const {
+    return m_levels.size();
+}
+
+
+const SpatialGrid &HierarchicalGrid::getLevel(size_t level) const {
+    return m_levels[level];
+}
+
+
+MemoryFootprint HierarchicalGrid::getFootprint() const {
+    MemoryFootprint bytes{m_levels.size() * sizeof(SpatialGrid), m_levels.capacity() * sizeof(SpatialGrid)};
+    for (auto& level : m_levels)
+        bytes += level.getFootprint();
+    return bytes;
+}
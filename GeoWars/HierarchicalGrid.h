@@ -0,0 +1,83 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_HIERARCHICALGRID_H
+#define GEOWARS_HIERARCHICALGRID_H
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "MemoryStats.h"
+#include "SpatialGrid.h"
+
+
+// Stack of uniform grids over the same area, each level's cells twice as wide as the
+// level below. An item goes into the finest level whose cells are at least as wide as
+// the item, so bullets and the special weapon never share a level and each level only
+// grows its queries by the largest radius it actually holds. A query visits every
+// level that has items, over just the cells its shape touches there. Same rules as
+// SpatialGrid otherwise: rebuilt from scratch, conservative, callers do the exact test.
+class HierarchicalGrid
+{
+private:
+    std::vector<SpatialGrid>    m_levels;
+    float                       m_baseCellSize{64.f};
+
+public:
+    HierarchicalGrid() = default;
+
+    void                        reset(const sf::FloatRect& bounds, float baseCellSize, size_t levels);
+    void                        clear();
+    void                        insert(std::uint32_t id, sf::Vector2f pos, float radius);
+    void                        build();
+
+    // level an item of this radius goes into, the top level takes everything too big
+    size_t                      levelFor(float radius) const;
+
+    size_t                      size() const;
+    size_t                      getLevelCount() const;
+    const SpatialGrid&          getLevel(size_t level) const;
+    MemoryFootprint             getFootprint() const;
+
+
+    // fn(id) for every item that may overlap the circle, finest level first.
+    // If fn returns bool, returning false stops the query.
+    template<typename Fn>
+    inline void queryCircle(sf::Vector2f center, float radius, Fn&& fn) const {
+        forLevels(fn, [&](const SpatialGrid& level, auto&& visit) { level.queryCircle(center, radius, visit); });
+    }
+
+
+    // fn(id) for every item that may overlap the rectangle, same stopping rule
+    template<typename Fn>
+    inline void queryRect(const sf::FloatRect& r, Fn&& fn) const {
+        forLevels(fn, [&](const SpatialGrid& level, auto&& visit) { level.queryRect(r, visit); });
+    }
+
+
+private:
+    template<typename Fn, typename Query>
+    inline void forLevels(Fn& fn, Query&& query) const {
+        if constexpr (std::is_same_v<std::invoke_result_t<Fn&, std::uint32_t>, bool>) {
+            bool more = true;
+            for (auto& level : m_levels) {
+                if (level.size() == 0)
+                    continue;
+                query(level, [&](std::uint32_t id) { return more = fn(id); });
+                if (!more)
+                    return;
+            }
+        }
+        else {
+            for (auto& level : m_levels) {
+                if (level.size() != 0)
+                    query(level, fn);
+            }
+        }
+    }
+};
+
+
+#endif //GEOWARS_HIERARCHICALGRID_H
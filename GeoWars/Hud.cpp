@@ -0,0 +1,94 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#include "Hud.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // the cache already holds colour times alpha (the text was blended onto transparent
+    // black), blending it by its alpha a second time would darken the glyph edges
+    const sf::BlendMode PREMULTIPLIED(sf::BlendMode::One, sf::BlendMode::OneMinusSrcAlpha);
+}
+
+
+void Hud::init() {
+    auto& stats = m_lines[Stats].text;
+    stats.setPosition(15.0f, 15.0f);
+    stats.setCharacterSize(15);
+
+    auto& score = m_lines[Score].text;
+    score.setPosition(5, 30);
+
+    // debug overlay, empty unless toggled on
+    auto& memory = m_lines[Memory].text;
+    memory.setPosition(15.0f, 75.0f);
+    memory.setCharacterSize(13);
+
+    // position while scrubbing through the rewind history
+    auto& rewind = m_lines[Rewind].text;
+    rewind.setPosition(15.0f, 115.0f);
+    rewind.setCharacterSize(15);
+
+    setText(Score, "Score: 0");
+    m_dirty = true;
+}
+
+
+void Hud::setFont(Field field, const sf::Font &font) {
+    m_lines[field].text.setFont(font);
+    m_dirty = true;
+}
+
+
+void Hud::setText(Field field, const std::string &value) {
+    auto& line = m_lines[field];
+    if (line.value == value)
+        return;
+
+    line.value = value;
+    line.text.setString(value);
+    m_dirty = true;
+}
+
+
+void Hud::rebuild() {
+    // the cache covers the union of all line bounds, measured from the top left corner
+    float right{0.f}, bottom{0.f};
+    for (auto& line : m_lines) {
+        auto bounds = line.text.getGlobalBounds();
+        right = std::max(right, bounds.left + bounds.width);
+        bottom = std::max(bottom, bounds.top + bounds.height);
+    }
+
+    auto width = static_cast<unsigned>(std::ceil(right)) + 1;
+    auto height = static_cast<unsigned>(std::ceil(bottom)) + 1;
+
+    // only reallocate when the text outgrows the texture
+    if (width > m_cacheSize.x || height > m_cacheSize.y) {
+        m_cacheSize.x = std::max(width, m_cacheSize.x);
+        m_cacheSize.y = std::max(height, m_cacheSize.y);
+        m_cache.create(m_cacheSize.x, m_cacheSize.y);
+        m_sprite.setTexture(m_cache.getTexture(), true);
+    }
+
+    m_cache.clear(sf::Color::Transparent);
+    for (auto& line : m_lines)
+        m_cache.draw(line.text);
+    m_cache.display();
+
+    m_dirty = false;
+}
+
+
+void Hud::draw(sf::RenderTarget &target) {
+    if (m_dirty)
+        rebuild();
+
+    // the HUD stays fixed to the screen whatever the world view is
+    auto view = target.getView();
+    target.setView(target.getDefaultView());
+    target.draw(m_sprite, sf::RenderStates(PREMULTIPLIED));
+    target.setView(view);
+}
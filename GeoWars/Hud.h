@@ -0,0 +1,50 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_HUD_H
+#define GEOWARS_HUD_H
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <string>
+
+
+// Text overlay drawn on top of the world. Lines are only laid out again when their
+// string changes; the result is cached in a render texture and composited with a
+// single sprite draw per frame.
+class Hud
+{
+public:
+    enum Field { Stats, Score, Memory, Rewind, FieldCount };
+
+private:
+    struct Line
+    {
+        sf::Text        text;
+        std::string     value;
+    };
+
+    std::array<Line, FieldCount>    m_lines;
+    sf::RenderTexture               m_cache;
+    sf::Sprite                      m_sprite;
+    sf::Vector2u                    m_cacheSize{0, 0};
+    bool                            m_dirty{true};
+
+    void                            rebuild();
+
+public:
+    Hud() = default;
+
+    void                            init();
+
+    // fonts arrive from the asset manager, a line without one is not drawn
+    void                            setFont(Field field, const sf::Font& font);
+
+    // no-op if the value did not change
+    void                            setText(Field field, const std::string& value);
+    void                            draw(sf::RenderTarget& target);
+};
+
+
+#endif //GEOWARS_HUD_H
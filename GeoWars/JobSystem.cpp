@@ -0,0 +1,91 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#include "JobSystem.h"
+#include <algorithm>
+
+
+JobSystem::JobSystem(size_t threads) {
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (size_t slot = 1; slot < threads; ++slot)
+        m_workers.emplace_back(&JobSystem::workerLoop, this, slot);
+}
+
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_wake.notify_all();
+    for (auto& t : m_workers)
+        t.join();
+}
+
+
+size_t JobSystem::getWorkerCount() const {
+    return m_workers.size() + 1;
+}
+
+
+void JobSystem::run(size_t count, size_t grain, Invoker invoke, void *fn) {
+    grain = std::max<size_t>(grain, 1);
+    if (m_workers.empty() || count <= grain) {
+        if (count > 0)
+            invoke(fn, 0, count, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_invoke = invoke;
+        m_job = fn;
+        m_count = count;
+        m_grain = grain;
+        m_next = 0;
+        m_busy = m_workers.size();
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    runChunks(0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_busy == 0; });
+    m_job = nullptr;
+}
+
+
+void JobSystem::workerLoop(size_t slot) {
+    size_t seen{0};
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_quit || m_generation != seen; });
+            if (m_quit)
+                return;
+            seen = m_generation;
+        }
+
+        runChunks(slot);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_busy == 0)
+            m_done.notify_one();
+    }
+}
+
+
+void JobSystem::runChunks(size_t slot) {
+    // chunks are handed out dynamically, callers that need a deterministic result
+    // must merge per-slot output by item index rather than by slot
+    while (true) {
+        size_t begin = m_next.fetch_add(m_grain);
+        if (begin >= m_count)
+            break;
+        m_invoke(m_job, begin, std::min(begin + m_grain, m_count), slot);
+    }
+}
@@ -0,0 +1,69 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_JOBSYSTEM_H
+#define GEOWARS_JOBSYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+// Fixed pool of worker threads used by systems to split a loop into chunks.
+// The calling thread takes part in the work as slot 0, workers are slots 1..n-1,
+// so a slot index can be used to pick a per-thread buffer (command buffers,
+// contact buffers, ...) without any locking.
+class JobSystem
+{
+    // type-erased fn(begin, end, slot), no allocation per call
+    using Invoker = void (*)(void* fn, size_t begin, size_t end, size_t slot);
+
+
+    std::vector<std::thread>    m_workers;
+    std::mutex                  m_mutex;
+    std::condition_variable     m_wake;
+    std::condition_variable     m_done;
+
+    Invoker                     m_invoke{nullptr};
+    void*                       m_job{nullptr};
+    size_t                      m_count{0};
+    size_t                      m_grain{1};
+    std::atomic<size_t>         m_next{0};
+    size_t                      m_busy{0};
+    size_t                      m_generation{0};
+    bool                        m_quit{false};
+
+    void                        workerLoop(size_t slot);
+    void                        runChunks(size_t slot);
+    void                        run(size_t count, size_t grain, Invoker invoke, void* fn);
+
+    template<typename Fn>
+    static void invoke(void* fn, size_t begin, size_t end, size_t slot) {
+        (*static_cast<Fn*>(fn))(begin, end, slot);
+    }
+
+public:
+    // threads == 0 picks one slot per hardware thread
+    explicit JobSystem(size_t threads = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    size_t                      getWorkerCount() const;
+
+    // Runs fn(begin, end, slot) over [0, count) in chunks of grain items and returns
+    // when all are done. Small loops (count <= grain) run inline on the calling thread.
+    template<typename Fn>
+    inline void parallelFor(size_t count, size_t grain, Fn&& fn) {
+        using F = std::remove_reference_t<Fn>;
+        run(count, grain, &invoke<F>, const_cast<void*>(static_cast<const void*>(&fn)));
+    }
+};
+
+
+#endif //GEOWARS_JOBSYSTEM_H
@@ -0,0 +1,256 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#include "Log.h"
+#include <cstdio>
+#include <iostream>
+#include <iterator>
+
+namespace {
+    const char* LEVEL_NAMES[]{"trace", "debug", "info", "warn", "error", "off"};
+    const char* CATEGORY_NAMES[]{"general", "config", "assets", "snapshot", "capture", "stream", "metrics", "collision", "spawn"};
+    static_assert(std::size(CATEGORY_NAMES) == static_cast<size_t>(LogCategory::Count));
+
+    // how long the writer sleeps when nobody asks for a flush
+    const auto DRAIN_INTERVAL = std::chrono::milliseconds(20);
+
+    // the ring this thread pushes into, handed back when the thread exits
+    struct RingOwner
+    {
+        std::atomic<bool>*  owned{nullptr};
+        void*               ring{nullptr};
+
+        ~RingOwner() {
+            if (owned)
+                owned->store(false, std::memory_order_release);
+        }
+    };
+    thread_local RingOwner t_ring;
+}
+
+
+Logger &Logger::get() {
+    static Logger logger;
+    return logger;
+}
+
+
+Logger::Logger()
+    : m_start(std::chrono::steady_clock::now()) {
+    for (auto& level : m_levels)
+        level.store(LogLevel::Info, std::memory_order_relaxed);
+    m_thread = std::thread(&Logger::writerLoop, this);
+}
+
+
+Logger::~Logger() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    m_thread.join();
+}
+
+
+void Logger::setLevel(LogLevel level) {
+    for (auto& l : m_levels)
+        l.store(level, std::memory_order_relaxed);
+}
+
+
+void Logger::setLevel(LogCategory category, LogLevel level) {
+    m_levels[static_cast<size_t>(category)].store(level, std::memory_order_relaxed);
+}
+
+
+LogLevel Logger::getLevel(LogCategory category) const {
+    return m_levels[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+}
+
+
+void Logger::setFile(const std::string &path) {
+    // every batch world reads the same config, only the first one opens the file
+    std::lock_guard<std::mutex> lock(m_outputMutex);
+    auto wanted = path == "-" ? std::string() : path;
+    if (wanted == m_filePath)
+        return;
+    m_file.close();
+    m_filePath = wanted;
+    if (m_filePath.empty())
+        return;
+    m_file.open(m_filePath, std::ios::trunc);
+    if (!m_file)
+        std::cerr << "Open log file " << path << " failed\n";
+}
+
+
+void Logger::flush() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto ticket = ++m_flushRequested;
+    m_wake.notify_all();
+    m_flushed.wait(lock, [&] { return m_flushDone >= ticket || m_stop; });
+}
+
+
+std::uint64_t Logger::getDropped() const {
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+
+Logger::Ring *Logger::acquireRing() {
+    // first log call on this thread: take over a ring whose thread has gone, or add one
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Ring* ring{nullptr};
+    for (auto& r : m_rings) {
+        if (!r->owned.load(std::memory_order_acquire)) {
+            ring = r.get();
+            ring->owned.store(true, std::memory_order_relaxed);
+            break;
+        }
+    }
+    if (ring == nullptr) {
+        m_rings.push_back(std::make_unique<Ring>());
+        ring = m_rings.back().get();
+    }
+    t_ring.owned = &ring->owned;
+    t_ring.ring = ring;
+    return ring;
+}
+
+
+void Logger::push(LogRecord &record) {
+    auto* ring = static_cast<Ring*>(t_ring.ring);
+    if (ring == nullptr)
+        ring = acquireRing();
+    record.time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count();
+    if (!ring->queue.push(record))
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+void Logger::writerLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_wake.wait_for(lock, DRAIN_INTERVAL, [this] { return m_stop || m_flushRequested != m_flushDone; });
+        // every record pushed before a flush() call is in a ring by the time it is seen here
+        auto ticket = m_flushRequested;
+        bool stop = m_stop;
+        collect();
+
+        // formatting and I/O happen unlocked, a thread logging for the first time
+        // can take its ring meanwhile
+        lock.unlock();
+        writeBatch();
+        lock.lock();
+
+        m_flushDone = ticket;
+        m_flushed.notify_all();
+        if (stop)
+            return;
+    }
+}
+
+
+void Logger::collect() {
+    // called with m_mutex held, so no ring is added or handed over meanwhile; producers
+    // keep pushing, whatever arrives after a ring was emptied waits for the next batch
+    m_batch.clear();
+    LogRecord record;
+    for (auto& ring : m_rings) {
+        while (ring->queue.pop(record))
+            m_batch.push_back(record);
+    }
+}
+
+
+void Logger::writeBatch() {
+    std::stable_sort(m_batch.begin(), m_batch.end(),
+                     [](const LogRecord& l, const LogRecord& r) { return l.time < r.time; });
+
+    std::lock_guard<std::mutex> lock(m_outputMutex);
+    for (auto& r : m_batch)
+        writeRecord(r);
+
+    auto dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped != m_droppedReported) {
+        std::cerr << "[log] " << dropped - m_droppedReported << " records dropped, the log rings were full\n";
+        m_droppedReported = dropped;
+    }
+    if (!m_batch.empty()) {
+        std::cout.flush();
+        if (m_file.is_open())
+            m_file.flush();
+    }
+}
+
+
+void Logger::writeRecord(const LogRecord &record) {
+    // the deferred part: formatting happens here, on the writer thread
+    std::string line;
+    line.reserve(128);
+    size_t arg = 0;
+    for (const char* p = record.format; *p != '\0'; ++p) {
+        if (p[0] != '{' || p[1] != '}' || arg == record.argCount) {
+            line += *p;
+            continue;
+        }
+        char number[32];
+        auto& a = record.args[arg];
+        switch (record.types[arg++]) {
+        case LogRecord::Int:
+            std::snprintf(number, sizeof(number), "%lld", static_cast<long long>(a.i));
+            line += number;
+            break;
+        case LogRecord::Uint:
+            std::snprintf(number, sizeof(number), "%llu", static_cast<unsigned long long>(a.u));
+            line += number;
+            break;
+        case LogRecord::Double:
+            std::snprintf(number, sizeof(number), "%g", a.d);
+            line += number;
+            break;
+        case LogRecord::Text:
+            line.append(record.text + a.text.offset, a.text.length);
+            break;
+        }
+        ++p;
+    }
+
+    // Info and below read like the plain output they replace, anything worse is tagged
+    auto level = static_cast<size_t>(record.level);
+    if (record.level >= LogLevel::Warn)
+        std::cerr << LEVEL_NAMES[level] << ": " << line << "\n";
+    else
+        std::cout << line << "\n";
+
+    if (m_file.is_open()) {
+        char stamp[48];
+        std::snprintf(stamp, sizeof(stamp), "%10.6f %-5s %-9s ", static_cast<double>(record.time) * 1e-6,
+                      LEVEL_NAMES[level], CATEGORY_NAMES[static_cast<size_t>(record.category)]);
+        m_file << stamp << line << "\n";
+    }
+}
+
+
+bool Logger::parseLevel(const std::string &name, LogLevel &level) {
+    for (size_t i = 0; i < std::size(LEVEL_NAMES); ++i) {
+        if (name == LEVEL_NAMES[i]) {
+            level = static_cast<LogLevel>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool Logger::parseCategory(const std::string &name, LogCategory &category) {
+    for (size_t i = 0; i < std::size(CATEGORY_NAMES); ++i) {
+        if (name == CATEGORY_NAMES[i]) {
+            category = static_cast<LogCategory>(i);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,199 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_LOG_H
+#define GEOWARS_LOG_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "SpscQueue.h"
+
+
+enum class LogLevel : std::uint8_t { Trace, Debug, Info, Warn, Error, Off };
+
+enum class LogCategory : std::uint8_t
+{
+    General, Config, Assets, Snapshot, Capture, Stream, Metrics, Collision, Spawn, Count
+};
+
+
+// One log call, fixed size so it can be copied into a ring as is. The format string
+// must be a literal (only its address is kept); "{}" in it is replaced by the next
+// argument when the record is written. String arguments are copied into text, cut
+// short when it runs out.
+struct LogRecord
+{
+    static constexpr size_t MAX_ARGS{8};
+    static constexpr size_t TEXT{88};
+
+    enum ArgType : std::uint8_t { Int, Uint, Double, Text };
+    union Arg
+    {
+        std::int64_t    i;
+        std::uint64_t   u;
+        double          d;
+        struct { std::uint16_t offset, length; } text;
+    };
+
+    std::int64_t        time{0};        // microseconds since the logger started
+    const char*         format{nullptr};
+    LogLevel            level{LogLevel::Info};
+    LogCategory         category{LogCategory::General};
+    std::uint8_t        argCount{0};
+    std::uint8_t        textSize{0};
+    ArgType             types[MAX_ARGS]{};
+    Arg                 args[MAX_ARGS]{};
+    char                text[TEXT]{};
+};
+
+
+// Asynchronous logger. A call that passes the level check fills a LogRecord and pushes
+// it into the calling thread's own lock-free ring; a background thread drains every
+// ring, puts each batch it drained in time order and only then formats it, so a log call
+// from inside a tick costs a few stores and never touches a stream. Ordering holds within
+// a batch only: a record that just missed one is written with the next, after records
+// from other threads that may be newer. When a ring is full the
+// record is dropped and counted rather than waiting. Levels are per category and can
+// be changed from any thread at any time. Info and below go to stdout, warnings and
+// errors to stderr, everything to the log file if one is set.
+class Logger
+{
+public:
+    static Logger&      get();
+
+    bool                enabled(LogCategory category, LogLevel level) const {
+        return level >= m_levels[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+    }
+
+    void                setLevel(LogLevel level);       // every category
+    void                setLevel(LogCategory category, LogLevel level);
+    LogLevel            getLevel(LogCategory category) const;
+    void                setFile(const std::string& path);   // "" or "-" = console only, same path = no change
+
+    // blocks until everything logged before the call has been written
+    void                flush();
+    std::uint64_t       getDropped() const;
+
+    void                push(LogRecord& record);
+
+    static bool         parseLevel(const std::string& name, LogLevel& level);
+    static bool         parseCategory(const std::string& name, LogCategory& category);
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+private:
+    // one per thread that has logged; a thread that exits gives its ring back for the
+    // next new thread to take over
+    struct Ring
+    {
+        SpscQueue<LogRecord, 512>   queue;
+        std::atomic<bool>           owned{true};
+    };
+
+    std::atomic<LogLevel>               m_levels[static_cast<size_t>(LogCategory::Count)];
+    std::atomic<std::uint64_t>          m_dropped{0};
+    std::chrono::steady_clock::time_point m_start;
+
+    std::mutex                          m_mutex;        // guards the rings and the flush state
+    std::vector<std::unique_ptr<Ring>>  m_rings;
+    std::condition_variable             m_wake;
+    std::condition_variable             m_flushed;
+    std::uint64_t                       m_flushRequested{0};
+    std::uint64_t                       m_flushDone{0};
+    bool                                m_stop{false};
+
+    std::mutex                          m_outputMutex;  // guards the file, held while a batch is written
+    std::ofstream                       m_file;
+    std::string                         m_filePath;
+
+    std::uint64_t                       m_droppedReported{0};   // writer thread only
+    std::vector<LogRecord>              m_batch;                // writer thread only
+    std::thread                         m_thread;
+
+    Logger();
+    ~Logger();
+
+    Ring*               acquireRing();
+    void                writerLoop();
+    void                collect();
+    void                writeBatch();
+    void                writeRecord(const LogRecord& record);
+};
+
+
+namespace Log {
+    namespace detail {
+        inline void addText(LogRecord& r, std::string_view s) {
+            size_t n = std::min(s.size(), LogRecord::TEXT - r.textSize);
+            std::memcpy(r.text + r.textSize, s.data(), n);
+            r.args[r.argCount].text = { r.textSize, static_cast<std::uint16_t>(n) };
+            r.types[r.argCount] = LogRecord::Text;
+            r.textSize = static_cast<std::uint8_t>(r.textSize + n);
+        }
+
+        template<typename T>
+        inline void add(LogRecord& r, const T& value) {
+            if (r.argCount == LogRecord::MAX_ARGS)
+                return;
+            if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+                addText(r, std::string_view(value));
+            }
+            else if constexpr (std::is_floating_point_v<T>) {
+                r.types[r.argCount] = LogRecord::Double;
+                r.args[r.argCount].d = value;
+            }
+            else if constexpr (std::is_signed_v<T>) {
+                r.types[r.argCount] = LogRecord::Int;
+                r.args[r.argCount].i = value;
+            }
+            else {
+                static_assert(std::is_integral_v<T>, "log arguments are numbers or strings");
+                r.types[r.argCount] = LogRecord::Uint;
+                r.args[r.argCount].u = value;
+            }
+            ++r.argCount;
+        }
+    }
+
+
+    template<typename... Args>
+    inline void write(LogLevel level, LogCategory category, const char* format, const Args&... args) {
+        auto& logger = Logger::get();
+        if (!logger.enabled(category, level))
+            return;
+        LogRecord r;
+        r.format = format;
+        r.level = level;
+        r.category = category;
+        (detail::add(r, args), ...);
+        logger.push(r);
+    }
+
+    template<typename... Args>
+    inline void trace(LogCategory category, const char* format, const Args&... args) { write(LogLevel::Trace, category, format, args...); }
+    template<typename... Args>
+    inline void debug(LogCategory category, const char* format, const Args&... args) { write(LogLevel::Debug, category, format, args...); }
+    template<typename... Args>
+    inline void info(LogCategory category, const char* format, const Args&... args)  { write(LogLevel::Info, category, format, args...); }
+    template<typename... Args>
+    inline void warn(LogCategory category, const char* format, const Args&... args)  { write(LogLevel::Warn, category, format, args...); }
+    template<typename... Args>
+    inline void error(LogCategory category, const char* format, const Args&... args) { write(LogLevel::Error, category, format, args...); }
+}
+
+
+#endif //GEOWARS_LOG_H
@@ -0,0 +1,40 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_MAPPEDFILE_H
+#define GEOWARS_MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+
+// Read-only memory mapping of a whole file (CreateFileMapping on Windows, mmap elsewhere).
+class MappedFile
+{
+private:
+    const std::byte*    m_data{nullptr};
+    size_t              m_size{0};
+#ifdef _WIN32
+    void*               m_file{nullptr};
+    void*               m_mapping{nullptr};
+#else
+    int                 m_fd{-1};
+#endif
+
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool                open(const std::string& path);
+    void                close();
+
+    const std::byte*    data() const;
+    size_t              size() const;
+};
+
+
+#endif //GEOWARS_MAPPEDFILE_H
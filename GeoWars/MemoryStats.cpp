@@ -0,0 +1,193 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#include "MemoryStats.h"
+#include "AllocationCounter.h"
+#include "Entity.h"
+#include "EntityManager.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+
+namespace {
+    const char* COMPONENT_NAMES[] = {"CShape", "CInput", "CCollision", "CTransform", "CLifespan", "CScore"};
+    static_assert(std::size(COMPONENT_NAMES) == std::tuple_size_v<ComponentTuple>, "name every component");
+
+    const char* GROUP_NAMES[] = {"component", "tag", "subsystem"};
+
+    // shared_ptr<Entity>(new Entity) allocates a separate control block: vtable, two counts, pointer
+    const size_t CONTROL_BLOCK{3 * sizeof(void*)};
+
+    // a map node is the value plus three links and a colour
+    const size_t MAP_NODE_OVERHEAD{4 * sizeof(void*)};
+
+    // what components own on the heap; an sf::Shape keeps its fill vertices (points + 2)
+    // and outline vertices ((points + 1) * 2), even a default constructed one
+    size_t heapBytes(const Component&) {
+        return 0;
+    }
+
+    size_t heapBytes(const CShape& s) {
+        auto n = s.circle.getPointCount();
+        return (n + 2 + (n + 1) * 2) * sizeof(sf::Vertex);
+    }
+
+    size_t heapBytes(const std::string& s) {
+        // short strings live inside the object
+        auto* begin = reinterpret_cast<const char*>(&s);
+        bool inPlace = s.data() >= begin && s.data() < begin + sizeof(s);
+        return inPlace ? 0 : s.capacity() + 1;
+    }
+
+    template<size_t... I>
+    size_t countComponents(const Entity& e, std::array<size_t, sizeof...(I)>& present,
+                           std::array<MemoryFootprint, sizeof...(I)>& bytes, std::index_sequence<I...>) {
+        size_t heap{0};
+        auto visit = [&](auto index) {
+            constexpr size_t i = decltype(index)::value;
+            auto& c = e.getComponent<std::tuple_element_t<i, ComponentTuple>>();
+            auto h = heapBytes(c);
+            heap += h;
+            bytes[i].reserved += sizeof(c) + h;
+            if (c.has) {
+                ++present[i];
+                bytes[i].used += sizeof(c) + h;
+            }
+        };
+        (visit(std::integral_constant<size_t, I>{}), ...);
+        return heap;
+    }
+
+    std::string formatBytes(size_t bytes) {
+        std::ostringstream s;
+        if (bytes >= 1024 * 1024)
+            s << std::fixed << std::setprecision(1) << bytes / (1024.0 * 1024.0) << " MB";
+        else if (bytes >= 1024)
+            s << std::fixed << std::setprecision(1) << bytes / 1024.0 << " KB";
+        else
+            s << bytes << " B";
+        return s.str();
+    }
+}
+
+
+void MemoryTracker::beginSample() {
+    for (auto& group : m_groups)
+        for (auto& e : group) {
+            e.count = 0;
+            e.bytes = MemoryFootprint{};
+        }
+}
+
+
+void MemoryTracker::add(Group group, const std::string &name, size_t count, MemoryFootprint bytes) {
+    auto& entries = m_groups[group];
+    auto it = std::find_if(entries.begin(), entries.end(), [&](const Entry& e) { return e.name == name; });
+    if (it == entries.end()) {
+        entries.push_back(Entry{name, 0, MemoryFootprint{}, 0});
+        it = entries.end() - 1;
+    }
+    it->count += count;
+    it->bytes += bytes;
+    it->peak = std::max(it->peak, it->bytes.reserved);
+}
+
+
+void MemoryTracker::sampleEntities(EntityManager &manager) {
+    constexpr size_t N = std::tuple_size_v<ComponentTuple>;
+    std::array<size_t, N> present{};
+    std::array<MemoryFootprint, N> componentBytes{};
+    MemoryFootprint entityBytes;
+
+    // one pass over the live entities, tags come out of the same walk
+    for (auto& [tag, entities] : manager.getEntityMap()) {
+        MemoryFootprint tagBytes;
+        for (auto& e : entities) {
+            auto heap = countComponents(*e, present, componentBytes, std::make_index_sequence<N>{});
+            size_t bytes = sizeof(Entity) + CONTROL_BLOCK + heapBytes(e->getTag()) + heap;
+            tagBytes += MemoryFootprint{bytes, bytes};
+        }
+        add(Tags, tag, entities.size(), tagBytes);
+        entityBytes += tagBytes;
+    }
+    for (size_t i = 0; i < N; ++i)
+        add(Components, COMPONENT_NAMES[i], present[i], componentBytes[i]);
+    add(Subsystems, "entities", manager.getEntities().size(), entityBytes);
+
+    // the same entities are referenced from the flat list, the tag buckets and the pending list
+    auto& all = manager.getEntities();
+    auto& pending = manager.getPendingEntities();
+    MemoryFootprint lists{(all.size() + pending.size()) * sizeof(sPtrEntt),
+                          (all.capacity() + pending.capacity()) * sizeof(sPtrEntt)};
+    for (auto& [tag, entities] : manager.getEntityMap()) {
+        size_t node = sizeof(EntityMap::value_type) + MAP_NODE_OVERHEAD + heapBytes(tag);
+        lists += MemoryFootprint{node + entities.size() * sizeof(sPtrEntt), node + entities.capacity() * sizeof(sPtrEntt)};
+    }
+    add(Subsystems, "entity lists", manager.getEntityMap().size() + 2, lists);
+}
+
+
+void MemoryTracker::endSample() {
+    m_total = MemoryFootprint{};
+    for (auto& e : m_groups[Subsystems])
+        m_total += e.bytes;
+    m_totalPeak = std::max(m_totalPeak, m_total.reserved);
+    m_heapInUse = heapBytesInUse();
+    m_heapPeak = heapBytesPeak();
+}
+
+
+const std::vector<MemoryTracker::Entry> &MemoryTracker::getEntries(Group group) const {
+    return m_groups[group];
+}
+
+
+MemoryFootprint MemoryTracker::getTotal() const {
+    return m_total;
+}
+
+
+size_t MemoryTracker::getTotalPeak() const {
+    return m_totalPeak;
+}
+
+
+std::string MemoryTracker::summary() const {
+    auto slack = m_total.reserved - m_total.used;
+    std::string s = "Memory: " + formatBytes(m_total.used) + " used / " + formatBytes(m_total.reserved)
+                    + " reserved (" + std::to_string(m_total.reserved ? slack * 100 / m_total.reserved : 0) + "% slack)"
+                    + ", peak " + formatBytes(m_totalPeak);
+    if (m_heapPeak != 0)
+        s += "   Heap: " + formatBytes(m_heapInUse) + ", peak " + formatBytes(m_heapPeak);
+
+    // the biggest subsystems, largest first
+    std::vector<const Entry*> top;
+    for (auto& e : m_groups[Subsystems])
+        top.push_back(&e);
+    std::sort(top.begin(), top.end(), [](auto* a, auto* b) { return a->bytes.reserved > b->bytes.reserved; });
+    for (size_t i = 0; i < top.size() && i < 3; ++i)
+        s += (i == 0 ? "\n" : "   ") + top[i]->name + " " + formatBytes(top[i]->bytes.reserved);
+    return s;
+}
+
+
+void MemoryTracker::print(std::ostream &out) const {
+    out << "memory by      name                count        used    reserved       slack        peak\n";
+    for (size_t g = 0; g < GroupCount; ++g) {
+        for (auto& e : m_groups[g]) {
+            out << std::left << std::setw(15) << GROUP_NAMES[g] << std::setw(16) << e.name << std::right
+                << std::setw(9) << e.count
+                << std::setw(12) << formatBytes(e.bytes.used)
+                << std::setw(12) << formatBytes(e.bytes.reserved)
+                << std::setw(12) << formatBytes(e.bytes.reserved - e.bytes.used)
+                << std::setw(12) << formatBytes(e.peak) << "\n";
+        }
+    }
+    out << "total: " << formatBytes(m_total.used) << " used, " << formatBytes(m_total.reserved)
+        << " reserved, peak " << formatBytes(m_totalPeak);
+    if (m_heapPeak != 0)
+        out << "; heap " << formatBytes(m_heapInUse) << ", peak " << formatBytes(m_heapPeak);
+    out << "\n";
+}
@@ -0,0 +1,73 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_MEMORYSTATS_H
+#define GEOWARS_MEMORYSTATS_H
+
+#include <array>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class EntityManager;
+
+
+// Bytes a structure holds: used by live data, reserved in total (capacity, fixed-size
+// storage); reserved - used is slack the layout wastes.
+struct MemoryFootprint
+{
+    size_t      used{0};
+    size_t      reserved{0};
+
+    MemoryFootprint& operator+=(const MemoryFootprint& o) { used += o.used; reserved += o.reserved; return *this; }
+};
+
+
+// Where the world's memory goes, by component type, by tag and by subsystem, with a
+// high-water mark for each. Figures are computed by walking the world and asking each
+// subsystem, so they are available in release builds; heap-owned parts SFML does not
+// expose (shape vertex buffers, shared_ptr control blocks) are estimated from sizes.
+// The heap totals come from the allocation hooks and are only tracked in debug builds.
+class MemoryTracker
+{
+public:
+    enum Group { Components, Tags, Subsystems, GroupCount };
+
+    struct Entry
+    {
+        std::string     name;
+        size_t          count{0};       // components, entities, buffers, ...
+        MemoryFootprint bytes;
+        size_t          peak{0};        // highest reserved seen
+    };
+
+private:
+    std::array<std::vector<Entry>, GroupCount>  m_groups;
+    MemoryFootprint                             m_total;        // sum of the subsystems
+    size_t                                      m_totalPeak{0};
+    size_t                                      m_heapInUse{0};
+    size_t                                      m_heapPeak{0};
+
+public:
+    // values go back to zero, peaks are kept (an entry that disappears reports 0)
+    void                        beginSample();
+    void                        add(Group group, const std::string& name, size_t count, MemoryFootprint bytes);
+
+    // components and tags, plus the "entities" and "entity lists" subsystems
+    void                        sampleEntities(EntityManager& manager);
+
+    void                        endSample();
+
+    const std::vector<Entry>&   getEntries(Group group) const;
+    MemoryFootprint             getTotal() const;
+    size_t                      getTotalPeak() const;
+
+    // one line for the overlay, a full table for reports
+    std::string                 summary() const;
+    void                        print(std::ostream& out) const;
+};
+
+
+#endif //GEOWARS_MEMORYSTATS_H
@@ -0,0 +1,289 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#include "Metrics.h"
+#include "Log.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+    void writeValue(std::ostream& out, double v) {
+        if (std::isinf(v))
+            out << (v > 0 ? "+Inf" : "-Inf");
+        else if (std::isnan(v))
+            out << "NaN";
+        else if (v == std::floor(v) && std::fabs(v) < 9007199254740992.0)
+            out << static_cast<std::int64_t>(v);    // counts stay exact, no exponent
+        else
+            out << std::setprecision(9) << v;
+    }
+
+    void writeSample(std::ostream& out, const std::string& name, const char* suffix,
+                     const std::string& labels, double v) {
+        out << name << suffix;
+        if (!labels.empty())
+            out << '{' << labels << '}';
+        out << ' ';
+        writeValue(out, v);
+        out << '\n';
+    }
+
+    std::string formatLabels(const MetricsRegistry::Labels& labels) {
+        std::string s;
+        for (auto& [key, value] : labels) {
+            if (!s.empty())
+                s += ',';
+            s += key;
+            s += "=\"";
+            for (char c : value) {
+                if (c == '\\' || c == '"')
+                    s += '\\';
+                if (c == '\n')
+                    s += "\\n";
+                else
+                    s += c;
+            }
+            s += '"';
+        }
+        return s;
+    }
+
+    const char* typeName(int type) {
+        static const char* names[] = {"counter", "gauge", "histogram"};
+        return names[type];
+    }
+}
+
+
+void Counter::write(std::ostream &out, const std::string &name, const std::string &labels) const {
+    writeSample(out, name, "", labels, m_value);
+}
+
+
+void Gauge::write(std::ostream &out, const std::string &name, const std::string &labels) const {
+    writeSample(out, name, "", labels, m_value);
+}
+
+
+Histogram::Histogram(std::vector<double> bounds)
+        : m_bounds(std::move(bounds))
+        , m_counts(m_bounds.size() + 1, 0) {
+    assert(std::is_sorted(m_bounds.begin(), m_bounds.end()) && "histogram bounds must ascend");
+}
+
+
+void Histogram::observe(double value) {
+    // a handful of buckets, a linear scan beats anything cleverer
+    size_t i = 0;
+    while (i < m_bounds.size() && value > m_bounds[i])
+        ++i;
+    ++m_counts[i];
+    m_sum += value;
+    ++m_count;
+}
+
+
+void Histogram::write(std::ostream &out, const std::string &name, const std::string &labels) const {
+    std::string bucketLabels = labels.empty() ? "" : labels + ",";
+    std::uint64_t cumulative{0};
+    for (size_t i = 0; i <= m_bounds.size(); ++i) {
+        cumulative += m_counts[i];
+        std::ostringstream le;
+        writeValue(le, i < m_bounds.size() ? m_bounds[i] : INFINITY);
+        writeSample(out, name, "_bucket", bucketLabels + "le=\"" + le.str() + "\"", static_cast<double>(cumulative));
+    }
+    writeSample(out, name, "_sum", labels, m_sum);
+    writeSample(out, name, "_count", labels, static_cast<double>(m_count));
+}
+
+
+MetricsRegistry::Series &MetricsRegistry::find(const std::string &name, const std::string &help, Type type,
+                                               const Labels &labels) {
+    auto& family = m_byName[name];
+    if (!family) {
+        m_families.push_back(std::make_unique<Family>(Family{name, help, type, {}}));
+        family = m_families.back().get();
+    }
+    assert(family->type == type && "metric registered again with another type");
+
+    auto formatted = formatLabels(labels);
+    for (auto& s : family->series)
+        if (s.labels == formatted)
+            return s;
+    family->series.push_back(Series{std::move(formatted), nullptr});
+    return family->series.back();
+}
+
+
+Counter &MetricsRegistry::counter(const std::string &name, const std::string &help, const Labels &labels) {
+    auto& s = find(name, help, CounterType, labels);
+    if (!s.metric)
+        s.metric = std::make_unique<Counter>();
+    return static_cast<Counter&>(*s.metric);
+}
+
+
+Gauge &MetricsRegistry::gauge(const std::string &name, const std::string &help, const Labels &labels) {
+    auto& s = find(name, help, GaugeType, labels);
+    if (!s.metric)
+        s.metric = std::make_unique<Gauge>();
+    return static_cast<Gauge&>(*s.metric);
+}
+
+
+Histogram &MetricsRegistry::histogram(const std::string &name, const std::string &help,
+                                      const std::vector<double> &bounds, const Labels &labels) {
+    auto& s = find(name, help, HistogramType, labels);
+    if (!s.metric)
+        s.metric = std::make_unique<Histogram>(bounds);
+    return static_cast<Histogram&>(*s.metric);
+}
+
+
+void MetricsRegistry::writeText(std::ostream &out) const {
+    for (auto& family : m_families) {
+        out << "# HELP " << family->name << ' ' << family->help << '\n';
+        out << "# TYPE " << family->name << ' ' << typeName(family->type) << '\n';
+        for (auto& s : family->series)
+            s.metric->write(out, family->name, s.labels);
+    }
+}
+
+
+std::string MetricsRegistry::toText() const {
+    std::ostringstream out;
+    writeText(out);
+    return out.str();
+}
+
+
+bool MetricsExporter::listen(unsigned short port) {
+    if (m_listener.listen(port, sf::IpAddress::LocalHost) != sf::Socket::Done) {
+        Log::error(LogCategory::Metrics, "Metrics could not listen on port {}", port);
+        return false;
+    }
+    m_listener.setBlocking(false);
+    m_listening = true;
+    Log::info(LogCategory::Metrics, "Metrics on http://localhost:{}/metrics", port);
+    return true;
+}
+
+
+void MetricsExporter::setFile(const std::string &path, sf::Time interval) {
+    m_filePath = path;
+    m_fileInterval = interval;
+    m_sinceWrite = sf::Time::Zero;
+}
+
+
+bool MetricsExporter::isEnabled() const {
+    return m_listening || !m_filePath.empty();
+}
+
+
+bool MetricsExporter::serve(Client &c, const MetricsRegistry &registry) {
+    // read until the end of the request headers, the body (if any) is ignored
+    if (c.response.empty()) {
+        char buffer[1024];
+        size_t received{0};
+        auto status = c.socket->receive(buffer, sizeof(buffer), received);
+        if (status == sf::Socket::Disconnected || status == sf::Socket::Error)
+            return false;
+        c.request.append(buffer, received);
+        if (c.request.size() > MAX_REQUEST)
+            return false;
+        if (c.request.find("\r\n\r\n") == std::string::npos)
+            return ++c.polls < MAX_POLLS;
+
+        std::string statusLine, body;
+        if (c.request.rfind("GET /metrics ", 0) == 0 || c.request.rfind("GET / ", 0) == 0) {
+            statusLine = "200 OK";
+            body = registry.toText();
+            ++m_scrapes;
+        }
+        else {
+            statusLine = "404 Not Found";
+            body = "only /metrics is served\n";
+        }
+        c.response = "HTTP/1.1 " + statusLine + "\r\n"
+                     "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                     "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                     "Connection: close\r\n\r\n" + body;
+    }
+
+    while (c.sent < c.response.size()) {
+        size_t sent{0};
+        auto status = c.socket->send(c.response.data() + c.sent, c.response.size() - c.sent, sent);
+        c.sent += sent;
+        if (status == sf::Socket::Done)
+            continue;
+        if (status == sf::Socket::Partial || status == sf::Socket::NotReady)
+            return ++c.polls < MAX_POLLS;
+        return false;
+    }
+    return false;   // response complete, close the connection
+}
+
+
+bool MetricsExporter::writeFile(const MetricsRegistry &registry) {
+    // write aside and rename, a reader never sees a half-written file
+    // (rename will not replace an existing file on Windows, hence the remove)
+    auto tmp = m_filePath + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::trunc);
+        if (!out) {
+            Log::error(LogCategory::Metrics, "Open metrics file {} for writing failed", tmp);
+            return false;
+        }
+        registry.writeText(out);
+        if (!out)
+            return false;
+    }
+    std::remove(m_filePath.c_str());
+    return std::rename(tmp.c_str(), m_filePath.c_str()) == 0;
+}
+
+
+void MetricsExporter::poll(const MetricsRegistry &registry, sf::Time dt) {
+    if (m_listening) {
+        while (true) {
+            auto socket = std::make_unique<sf::TcpSocket>();
+            if (m_listener.accept(*socket) != sf::Socket::Done)
+                break;
+            socket->setBlocking(false);
+            Client c;
+            c.socket = std::move(socket);
+            m_clients.push_back(std::move(c));
+        }
+
+        // done, disconnected or idle for too long
+        m_clients.erase(std::remove_if(m_clients.begin(), m_clients.end(), [&](Client& c) {
+            return !serve(c, registry);
+        }), m_clients.end());
+    }
+
+    if (!m_filePath.empty()) {
+        m_sinceWrite += dt;
+        if (m_sinceWrite >= m_fileInterval) {
+            m_sinceWrite = sf::Time::Zero;
+            writeFile(registry);
+        }
+    }
+}
+
+
+void MetricsExporter::flush(const MetricsRegistry &registry) {
+    if (!m_filePath.empty())
+        writeFile(registry);
+}
+
+
+std::uint64_t MetricsExporter::getScrapes() const {
+    return m_scrapes;
+}
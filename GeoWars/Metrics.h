@@ -0,0 +1,176 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_METRICS_H
+#define GEOWARS_METRICS_H
+
+#include <SFML/Network.hpp>
+#include <SFML/System.hpp>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+// Counters, gauges and histograms in the Prometheus data model. Metrics are registered
+// once (registration allocates) and updated through the returned references, which is
+// just arithmetic, so they can be fed from inside a tick. Everything lives on the main
+// thread, nothing here is synchronised.
+class Metric
+{
+public:
+    virtual ~Metric() = default;
+    virtual void    write(std::ostream& out, const std::string& name, const std::string& labels) const = 0;
+};
+
+
+// only goes up; mirror a monotonic total with increment(total - value())
+class Counter : public Metric
+{
+private:
+    double          m_value{0.0};
+
+public:
+    void            increment(double by = 1.0)  { m_value += by; }
+    double          value() const               { return m_value; }
+    void            write(std::ostream& out, const std::string& name, const std::string& labels) const override;
+};
+
+
+class Gauge : public Metric
+{
+private:
+    double          m_value{0.0};
+
+public:
+    void            set(double value)           { m_value = value; }
+    void            add(double by)              { m_value += by; }
+    double          value() const               { return m_value; }
+    void            write(std::ostream& out, const std::string& name, const std::string& labels) const override;
+};
+
+
+// cumulative buckets with upper bounds in ascending order, +Inf is implied
+class Histogram : public Metric
+{
+private:
+    std::vector<double>         m_bounds;
+    std::vector<std::uint64_t>  m_counts;       // per bucket, not cumulative, last one is +Inf
+    double                      m_sum{0.0};
+    std::uint64_t               m_count{0};
+
+public:
+    explicit Histogram(std::vector<double> bounds);
+
+    void            observe(double value);
+    std::uint64_t   getCount() const            { return m_count; }
+    double          getSum() const              { return m_sum; }
+    void            write(std::ostream& out, const std::string& name, const std::string& labels) const override;
+};
+
+
+// Times a scope into a histogram, in seconds.
+class ScopedTimer
+{
+private:
+    Histogram&      m_histogram;
+    sf::Clock       m_clock;
+
+public:
+    explicit ScopedTimer(Histogram& histogram) : m_histogram(histogram) {}
+    ~ScopedTimer()                              { m_histogram.observe(m_clock.getElapsedTime().asSeconds()); }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
+
+
+class MetricsRegistry
+{
+public:
+    using Labels = std::vector<std::pair<std::string, std::string>>;
+
+private:
+    enum Type { CounterType, GaugeType, HistogramType };
+
+    struct Series
+    {
+        std::string                 labels;     // already formatted: a="x",b="y"
+        std::unique_ptr<Metric>     metric;
+    };
+
+    struct Family
+    {
+        std::string                 name;
+        std::string                 help;
+        Type                        type;
+        std::vector<Series>         series;
+    };
+
+    std::vector<std::unique_ptr<Family>>                m_families;     // exposition order
+    std::unordered_map<std::string, Family*>            m_byName;
+
+    Series&                 find(const std::string& name, const std::string& help, Type type, const Labels& labels);
+
+public:
+    // the same name and labels always return the same metric
+    Counter&                counter(const std::string& name, const std::string& help, const Labels& labels = {});
+    Gauge&                  gauge(const std::string& name, const std::string& help, const Labels& labels = {});
+    Histogram&              histogram(const std::string& name, const std::string& help,
+                                      const std::vector<double>& bounds, const Labels& labels = {});
+
+    // Prometheus text exposition format 0.0.4
+    void                    writeText(std::ostream& out) const;
+    std::string             toText() const;
+};
+
+
+// Serves the registry as Prometheus text on http://localhost:<port>/metrics and/or
+// rewrites a file with it every interval. Sockets are non-blocking and served from
+// poll(), once per frame, the same way the state stream is.
+class MetricsExporter
+{
+private:
+    struct Client
+    {
+        std::unique_ptr<sf::TcpSocket>  socket;
+        std::string                     request;
+        std::string                     response;   // bytes not yet accepted by the socket
+        size_t                          sent{0};
+        unsigned                        polls{0};
+    };
+
+    static const size_t                 MAX_REQUEST{8 * 1024};
+    static const unsigned               MAX_POLLS{600};     // frames before an idle client is dropped
+
+    sf::TcpListener                     m_listener;
+    std::vector<Client>                 m_clients;
+    bool                                m_listening{false};
+    std::string                         m_filePath;
+    sf::Time                            m_fileInterval{sf::seconds(10.f)};
+    sf::Time                            m_sinceWrite{sf::Time::Zero};
+    std::uint64_t                       m_scrapes{0};
+
+    bool                                serve(Client& c, const MetricsRegistry& registry);
+    bool                                writeFile(const MetricsRegistry& registry);
+
+public:
+    bool                                listen(unsigned short port);
+    void                                setFile(const std::string& path, sf::Time interval);
+    bool                                isEnabled() const;
+
+    void                                poll(const MetricsRegistry& registry, sf::Time dt);
+
+    // final write of the file, e.g. on exit
+    void                                flush(const MetricsRegistry& registry);
+
+    // /metrics requests answered, exported as geowars_metrics_scrapes_total
+    std::uint64_t                       getScrapes() const;
+};
+
+
+#endif //GEOWARS_METRICS_H
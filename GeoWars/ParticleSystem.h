@@ -0,0 +1,57 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_PARTICLESYSTEM_H
+#define GEOWARS_PARTICLESYSTEM_H
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <vector>
+#include "Rng.h"
+#include "MemoryStats.h"
+
+
+// Purely cosmetic particles (hit sparks, explosion debris). They never become entities
+// and never collide. Each attribute lives in its own array so update() is a handful of
+// straight loops the compiler can vectorise; storage is a fixed ring, a burst that does
+// not fit overwrites the oldest particles. Everything alive is drawn with one
+// vertex array.
+class ParticleSystem
+{
+private:
+    size_t                      m_capacity{0};
+    size_t                      m_next{0};      // ring write position
+    size_t                      m_used{0};      // slots written at least once
+
+    std::vector<float>          m_posX, m_posY;
+    std::vector<float>          m_velX, m_velY;
+    std::vector<float>          m_life;         // seconds left, <= 0 is dead
+    std::vector<float>          m_invTotal;     // 1 / lifetime, for the fade
+    std::vector<sf::Color>      m_color;
+
+    sf::VertexArray             m_vertices{sf::Quads};
+    float                       m_size{3.f};    // quad edge in world units
+    float                       m_drag{2.f};    // velocity lost per second, as a fraction
+
+public:
+    ParticleSystem() = default;
+
+    // 0 disables the system, emit() does nothing
+    void                        reset(size_t capacity, float size = 3.f, float drag = 2.f);
+
+    // count particles flying out of pos in random directions
+    void                        emit(sf::Vector2f pos, size_t count, sf::Color color,
+                                     float minSpeed, float maxSpeed, float lifetime, Rng& rng);
+
+    void                        update(sf::Time dt);
+    void                        draw(sf::RenderTarget& target, const sf::FloatRect& view);
+    void                        clear();
+
+    size_t                      getCapacity() const;
+    size_t                      getAlive() const;
+    MemoryFootprint             getFootprint() const;      // used = alive particles
+};
+
+
+#endif //GEOWARS_PARTICLESYSTEM_H
@@ -0,0 +1,80 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#include "QualityController.h"
+#include <algorithm>
+#include <numeric>
+
+
+void QualityController::configure(sf::Time budget, int maxLevel) {
+    m_budget = budget.asSeconds();
+    m_maxLevel = std::clamp(maxLevel, 0, LevelCount - 1);
+    m_level = std::min(m_level, m_maxLevel);
+    m_count = 0;
+    m_goodWindows = 0;
+}
+
+
+bool QualityController::addFrame(sf::Time frameTime) {
+    m_frames[m_count++] = frameTime.asSeconds();
+    if (m_count < WINDOW)
+        return false;
+
+    float average = std::accumulate(m_frames.begin(), m_frames.end(), 0.f) / WINDOW;
+    m_count = 0;
+
+    int level = m_level;
+    if (average > m_budget) {
+        m_goodWindows = 0;
+        level = std::min(m_level + 1, m_maxLevel);
+    }
+    else if (average < m_budget * HEADROOM) {
+        if (++m_goodWindows >= RESTORE_WINDOWS) {
+            m_goodWindows = 0;
+            level = std::max(m_level - 1, 0);
+        }
+    }
+    else {
+        m_goodWindows = 0;
+    }
+
+    bool changed = level != m_level;
+    m_level = level;
+    return changed;
+}
+
+
+int QualityController::getLevel() const {
+    return m_level;
+}
+
+
+const char *QualityController::getLevelName() const {
+    static const char* names[LevelCount] = {"full", "no outlines", "low detail", "no fade", "few fragments"};
+    return names[m_level];
+}
+
+
+bool QualityController::drawOutlines() const {
+    return m_level < NoOutlines;
+}
+
+
+bool QualityController::alphaFade() const {
+    return m_level < NoFade;
+}
+
+
+size_t QualityController::polygonPoints(size_t points) const {
+    if (m_level < LowDetail)
+        return points;
+    return std::max<size_t>(points / 2, 3);
+}
+
+
+size_t QualityController::fragments(size_t count) const {
+    if (m_level < FewFragments)
+        return count;
+    return std::max<size_t>((count + 1) / 2, 1);
+}
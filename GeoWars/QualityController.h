@@ -0,0 +1,54 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_QUALITYCONTROLLER_H
+#define GEOWARS_QUALITYCONTROLLER_H
+
+#include <SFML/System.hpp>
+#include <array>
+#include <cstddef>
+
+
+// Picks a render quality level from the measured frame time. Frames are averaged over a
+// short window; one window over budget drops a level, several windows in a row with
+// plenty of headroom bring one back. The gap between the two thresholds keeps the
+// level from flickering around the budget.
+class QualityController
+{
+public:
+    // each level also applies everything below it
+    enum Level { Full, NoOutlines, LowDetail, NoFade, FewFragments, LevelCount };
+
+private:
+    static constexpr size_t     WINDOW{30};             // frames per average
+    static constexpr int        RESTORE_WINDOWS{3};     // good windows before restoring a level
+    static constexpr float      HEADROOM{0.7f};         // "good" is below this fraction of the budget
+
+    std::array<float, WINDOW>   m_frames{};             // seconds
+    size_t                      m_count{0};
+    float                       m_budget{1.f / 60.f};
+    int                         m_maxLevel{LevelCount - 1};
+    int                         m_level{Full};
+    int                         m_goodWindows{0};
+
+public:
+    QualityController() = default;
+
+    // maxLevel 0 keeps full quality whatever the frame time
+    void                        configure(sf::Time budget, int maxLevel);
+
+    // returns true if the level changed
+    bool                        addFrame(sf::Time frameTime);
+
+    int                         getLevel() const;
+    const char*                 getLevelName() const;
+
+    bool                        drawOutlines() const;
+    bool                        alphaFade() const;
+    size_t                      polygonPoints(size_t points) const;
+    size_t                      fragments(size_t count) const;
+};
+
+
+#endif //GEOWARS_QUALITYCONTROLLER_H
@@ -0,0 +1,302 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#include "RewindBuffer.h"
+#include "Entity.h"
+#include "EntityManager.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace {
+    // delta frames are a list of operations in id order: kind, id, then the payload
+    enum Op : std::uint8_t { Create, Destroy, Change };
+
+    template<typename T>
+    void put(std::uint8_t*& p, const T& value) {
+        std::memcpy(p, &value, sizeof(T));
+        p += sizeof(T);
+    }
+
+    template<typename T>
+    T get(const std::uint8_t*& p) {
+        T value;
+        std::memcpy(&value, p, sizeof(T));
+        p += sizeof(T);
+        return value;
+    }
+
+    bool byId(const SnapshotEntity& l, const SnapshotEntity& r) {
+        return l.id < r.id;
+    }
+
+    const size_t NONE{std::numeric_limits<size_t>::max()};
+}
+
+
+void RewindBuffer::configure(size_t ticks, size_t bytes, size_t keyframeInterval) {
+    m_frames.assign(ticks, Frame{});
+    m_bytes.assign(ticks != 0 ? bytes : 0, 0);
+    m_keyframeInterval = std::max<size_t>(keyframeInterval, 1);
+    clear();
+}
+
+
+bool RewindBuffer::isEnabled() const {
+    return !m_frames.empty() && !m_bytes.empty();
+}
+
+
+void RewindBuffer::clear() {
+    m_first = 0;
+    m_count = 0;
+    m_write = 0;
+    m_sinceKeyframe = 0;
+    m_needKeyframe = true;
+    m_restored = NONE;
+    m_previous.clear();
+}
+
+
+RewindBuffer::Frame &RewindBuffer::frame(size_t index) {
+    return m_frames[(m_first + index) % m_frames.size()];
+}
+
+
+const RewindBuffer::Frame &RewindBuffer::frame(size_t index) const {
+    return m_frames[(m_first + index) % m_frames.size()];
+}
+
+
+std::uint32_t RewindBuffer::tagIndex(const std::string &tag) {
+    // a handful of tags, a linear search beats hashing the string
+    auto it = std::find(m_tags.begin(), m_tags.end(), tag);
+    if (it != m_tags.end())
+        return static_cast<std::uint32_t>(it - m_tags.begin());
+    m_tags.push_back(tag);
+    return static_cast<std::uint32_t>(m_tags.size() - 1);
+}
+
+
+void RewindBuffer::capture(EntityManager &manager, const RewindGlobals &globals) {
+    if (!isEnabled())
+        return;
+
+    // play resumed from a restored frame: the frames after it are another timeline
+    if (m_restored != NONE) {
+        m_count = m_restored + 1;
+        m_write = frame(m_restored).offset + frame(m_restored).size;
+        m_restored = NONE;
+    }
+
+    m_current.clear();
+    const EntityVec& live = manager.getEntities();
+    for (auto* entities : { &live, &manager.getPendingEntities() }) {
+        for (auto& e : *entities)
+            if (e->isActive())
+                m_current.push_back(packEntity(*e, tagIndex(e->getTag())));
+    }
+    // ids only grow, so this is sorted already unless a snapshot was loaded out of order
+    if (!std::is_sorted(m_current.begin(), m_current.end(), byId))
+        std::sort(m_current.begin(), m_current.end(), byId);
+
+    // sized for the worst case, which only grows with the entity count, so a tick that
+    // creates and destroys nothing never grows it
+    size_t worst = (m_current.size() + m_previous.size()) * (sizeof(SnapshotEntity) + 11);
+    if (m_scratch.size() < worst)
+        m_scratch.resize(worst);
+    m_scratchSize = 0;
+
+    bool keyframe = m_needKeyframe || m_count == 0 || m_sinceKeyframe + 1 >= m_keyframeInterval;
+    if (!keyframe)
+        encodeDelta();
+    store(globals, manager.getNextId(), keyframe);
+    m_previous.swap(m_current);
+}
+
+
+void RewindBuffer::encodeDelta() {
+    // both lists are sorted by id, one merge walk finds everything that changed
+    auto* out = m_scratch.data();
+    size_t i = 0;
+    size_t j = 0;
+    while (i < m_previous.size() || j < m_current.size()) {
+        if (j == m_current.size() || (i < m_previous.size() && m_previous[i].id < m_current[j].id)) {
+            put(out, Destroy);
+            put(out, m_previous[i++].id);
+        }
+        else if (i == m_previous.size() || m_current[j].id < m_previous[i].id) {
+            put(out, Create);
+            put(out, m_current[j].id);
+            put(out, m_current[j++]);
+        }
+        else {
+            std::uint64_t before[WORDS], after[WORDS];
+            std::memcpy(before, &m_previous[i++], sizeof(before));
+            std::memcpy(after, &m_current[j++], sizeof(after));
+            std::uint16_t mask{0};
+            for (size_t w = 0; w < WORDS; ++w)
+                if (before[w] != after[w])
+                    mask |= std::uint16_t(1u << w);
+            if (mask == 0)
+                continue;
+            put(out, Change);
+            put(out, after[0]);     // the id is word 0
+            put(out, mask);
+            for (size_t w = 0; w < WORDS; ++w)
+                if (mask & (1u << w))
+                    put(out, after[w]);
+        }
+    }
+    m_scratchSize = static_cast<size_t>(out - m_scratch.data());
+}
+
+
+void RewindBuffer::applyDelta(const Frame &f, std::vector<SnapshotEntity> &records) {
+    const std::uint8_t* p = m_bytes.data() + f.offset;
+    const std::uint8_t* end = p + f.size;
+
+    m_current.clear();
+    size_t i = 0;
+    while (p < end) {
+        auto op = get<Op>(p);
+        auto id = get<std::uint64_t>(p);
+        while (i < records.size() && records[i].id < id)
+            m_current.push_back(records[i++]);
+        bool found = i < records.size() && records[i].id == id;
+
+        if (op == Create) {
+            m_current.push_back(get<SnapshotEntity>(p));
+        }
+        else if (op == Destroy) {
+            if (found)
+                ++i;
+        }
+        else {
+            auto mask = get<std::uint16_t>(p);
+            std::uint64_t words[WORDS]{};
+            if (found)
+                std::memcpy(words, &records[i++], sizeof(words));
+            for (size_t w = 0; w < WORDS; ++w)
+                if (mask & (1u << w))
+                    words[w] = get<std::uint64_t>(p);
+            SnapshotEntity rec;
+            std::memcpy(&rec, words, sizeof(rec));
+            m_current.push_back(rec);
+        }
+    }
+    m_current.insert(m_current.end(), records.begin() + static_cast<std::ptrdiff_t>(i), records.end());
+    records.swap(m_current);
+}
+
+
+void RewindBuffer::store(const RewindGlobals &globals, std::uint64_t nextEntityId, bool keyframe) {
+    auto* data = keyframe ? reinterpret_cast<const std::uint8_t*>(m_current.data()) : m_scratch.data();
+    size_t size = keyframe ? m_current.size() * sizeof(SnapshotEntity) : m_scratchSize;
+
+    if (size > m_bytes.size()) {
+        // a frame bigger than the whole buffer, there is no history to keep
+        clear();
+        return;
+    }
+
+    // make room: the oldest frames are the ones right after the write position
+    if (m_count == m_frames.size())
+        dropOldest();
+    if (m_count == 0)
+        m_write = 0;
+    if (m_write + size > m_bytes.size()) {
+        while (m_count != 0 && frame(0).offset >= m_write)
+            dropOldest();
+        m_write = 0;
+    }
+    while (m_count != 0 && frame(0).offset < m_write + size && frame(0).offset + frame(0).size > m_write)
+        dropOldest();
+
+    // the keyframe this delta builds on was overwritten, store the whole world instead
+    if (!keyframe && m_count == 0) {
+        store(globals, nextEntityId, true);
+        return;
+    }
+
+    if (size != 0)
+        std::memcpy(m_bytes.data() + m_write, data, size);
+    auto& f = frame(m_count);
+    f.offset = m_write;
+    f.size = size;
+    f.nextEntityId = nextEntityId;
+    f.keyframe = keyframe;
+    f.globals = globals;
+    ++m_count;
+    m_write += size;
+    m_capturedBytes += size;
+    ++m_capturedFrames;
+
+    m_sinceKeyframe = keyframe ? 0 : m_sinceKeyframe + 1;
+    m_needKeyframe = false;
+}
+
+
+void RewindBuffer::dropOldest() {
+    // the history has to start at a keyframe, deltas without theirs go too
+    do {
+        m_first = (m_first + 1) % m_frames.size();
+        --m_count;
+    } while (m_count != 0 && !frame(0).keyframe);
+}
+
+
+size_t RewindBuffer::size() const {
+    return m_count;
+}
+
+
+std::uint64_t RewindBuffer::getTick(size_t index) const {
+    return frame(index).globals.tick;
+}
+
+
+bool RewindBuffer::restore(size_t index, EntityManager &manager, RewindGlobals &globals) {
+    if (index >= m_count)
+        return false;
+
+    // decode forward from the keyframe at or before the frame, straight into m_previous:
+    // that is the world the next capture compares against
+    size_t key = index;
+    while (!frame(key).keyframe)
+        --key;
+    auto& keyFrame = frame(key);
+    m_previous.resize(keyFrame.size / sizeof(SnapshotEntity));
+    std::memcpy(m_previous.data(), m_bytes.data() + keyFrame.offset, keyFrame.size);
+    for (size_t k = key + 1; k <= index; ++k)
+        applyDelta(frame(k), m_previous);
+
+    auto& f = frame(index);
+    manager.reset(f.nextEntityId);
+    for (auto& rec : m_previous) {
+        auto e = manager.restoreEntity(rec.id, m_tags[rec.tag]);
+        unpackEntity(rec, *e);
+    }
+    globals = f.globals;
+
+    m_restored = index;
+    m_sinceKeyframe = index - key;
+    return true;
+}
+
+
+MemoryFootprint RewindBuffer::getFootprint() const {
+    size_t used{0};
+    for (size_t i = 0; i < m_count; ++i)
+        used += frame(i).size;
+    used += m_count * sizeof(Frame) + (m_previous.size() + m_current.size()) * sizeof(SnapshotEntity) + m_scratchSize;
+    size_t reserved = m_bytes.capacity() + m_frames.capacity() * sizeof(Frame)
+                      + (m_previous.capacity() + m_current.capacity()) * sizeof(SnapshotEntity) + m_scratch.capacity();
+    return MemoryFootprint{used, reserved};
+}
+
+
+std::uint64_t RewindBuffer::getAverageFrameBytes() const {
+    return m_capturedFrames == 0 ? 0 : m_capturedBytes / m_capturedFrames;
+}
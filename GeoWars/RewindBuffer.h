@@ -0,0 +1,107 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_REWINDBUFFER_H
+#define GEOWARS_REWINDBUFFER_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MemoryStats.h"
+#include "Rng.h"
+#include "Snapshot.h"
+
+// forward declarations
+class EntityManager;
+
+
+// World state outside the entity manager, fixed size so capturing it never allocates.
+// Spawn requests queued in the budget and the progress of running waves are not part
+// of it, so resuming from a frame can diverge from the run that recorded it
+struct RewindGlobals
+{
+    std::uint64_t               tick{0};
+    std::int64_t                spawnCountdownUs{0};
+    std::int32_t                score{0};
+    std::int32_t                specialWeaponCount{0};
+    std::array<Rng::State, 2>   rng{};          // master, spawner
+};
+
+
+// The last few seconds of world state, one frame per tick, in a fixed block of memory.
+// Every keyframeInterval ticks a frame holds every entity as a SnapshotEntity record;
+// the frames in between only hold what changed since the tick before: created records,
+// destroyed ids, and for changed entities the 8-byte words of the record that differ.
+// Frames are written back to back into a byte ring and the oldest are overwritten, the
+// history always starts at a keyframe. Once the world has stopped growing capturing
+// does not allocate.
+class RewindBuffer
+{
+private:
+    static constexpr size_t WORDS{sizeof(SnapshotEntity) / sizeof(std::uint64_t)};
+    static_assert(WORDS <= 16, "changed words are flagged in a 16-bit mask");
+
+    struct Frame
+    {
+        size_t              offset{0};      // into m_bytes
+        size_t              size{0};
+        std::uint64_t       nextEntityId{0};
+        bool                keyframe{false};
+        RewindGlobals       globals;
+    };
+
+    std::vector<std::uint8_t>       m_bytes;
+    std::vector<Frame>              m_frames;       // ring, m_first is the oldest
+    size_t                          m_first{0};
+    size_t                          m_count{0};
+    size_t                          m_write{0};     // where the next frame goes in m_bytes
+    size_t                          m_keyframeInterval{60};
+    size_t                          m_sinceKeyframe{0};
+    bool                            m_needKeyframe{true};
+    size_t                          m_restored{SIZE_MAX};   // frame the world was restored to, until the next capture
+
+    std::vector<std::string>        m_tags;         // SnapshotEntity::tag indexes this
+    std::vector<SnapshotEntity>     m_previous;     // the world at the last capture, by id
+    std::vector<SnapshotEntity>     m_current;
+    std::vector<std::uint8_t>       m_scratch;      // the frame being encoded, worst case sized
+    size_t                          m_scratchSize{0};
+    std::uint64_t                   m_capturedBytes{0};
+    std::uint64_t                   m_capturedFrames{0};
+
+    Frame&                          frame(size_t index);
+    const Frame&                    frame(size_t index) const;
+    std::uint32_t                   tagIndex(const std::string& tag);
+    void                            encodeDelta();
+    void                            applyDelta(const Frame& f, std::vector<SnapshotEntity>& records);
+    void                            store(const RewindGlobals& globals, std::uint64_t nextEntityId, bool keyframe);
+    void                            dropOldest();
+
+public:
+    RewindBuffer() = default;
+
+    // ticks of history and memory for it; 0 ticks = off
+    void                            configure(size_t ticks, size_t bytes, size_t keyframeInterval);
+    bool                            isEnabled() const;
+    void                            clear();
+
+    // once per tick, after the systems ran; pending entities are included
+    void                            capture(EntityManager& manager, const RewindGlobals& globals);
+
+    // frames are numbered oldest first, 0 .. size() - 1
+    size_t                          size() const;
+    std::uint64_t                   getTick(size_t index) const;
+
+    // replaces every entity in the manager with frame index; the frames after it stay
+    // until the next capture, which drops them and continues from the restored world
+    bool                            restore(size_t index, EntityManager& manager, RewindGlobals& globals);
+
+    MemoryFootprint                 getFootprint() const;
+
+    // encoded size of a frame averaged over every capture so far, the per-tick memory cost
+    std::uint64_t                   getAverageFrameBytes() const;
+};
+
+
+#endif //GEOWARS_REWINDBUFFER_H
@@ -0,0 +1,102 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_RNG_H
+#define GEOWARS_RNG_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+
+// xoshiro256** (Blackman & Vigna): 32 bytes of state, a few cycles per number, and a
+// jump function that advances 2^128 steps so one seed can be split into many
+// non-overlapping streams (one per system or per worker thread).
+// Satisfies UniformRandomBitGenerator, so it works with the <random> distributions.
+class Rng
+{
+public:
+    using result_type = std::uint64_t;
+    using State = std::array<std::uint64_t, 4>;
+
+private:
+    State               m_s{};
+
+    static inline std::uint64_t rotl(std::uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+public:
+    explicit Rng(std::uint64_t seed = 0x853c49e6748fea9bULL) {
+        this->seed(seed);
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+
+    // the state is filled from splitmix64 so any seed (even 0) gives a good start
+    inline void seed(std::uint64_t seed) {
+        for (auto& word : m_s) {
+            std::uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            word = z ^ (z >> 31);
+        }
+    }
+
+
+    inline result_type operator()() {
+        const std::uint64_t result = rotl(m_s[1] * 5, 7) * 9;
+        const std::uint64_t t = m_s[1] << 17;
+        m_s[2] ^= m_s[0];
+        m_s[3] ^= m_s[1];
+        m_s[1] ^= m_s[2];
+        m_s[0] ^= m_s[3];
+        m_s[2] ^= t;
+        m_s[3] = rotl(m_s[3], 45);
+        return result;
+    }
+
+
+    // equivalent to 2^128 calls to operator()
+    inline void jump() {
+        static const std::uint64_t JUMP[] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                                              0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+        State s{};
+        for (auto j : JUMP) {
+            for (int b = 0; b < 64; ++b) {
+                if (j & (std::uint64_t(1) << b)) {
+                    for (std::size_t i = 0; i < s.size(); ++i)
+                        s[i] ^= m_s[i];
+                }
+                (*this)();
+            }
+        }
+        m_s = s;
+    }
+
+
+    // returns a generator for the current stream and moves this one 2^128 steps on,
+    // so repeated splits hand out independent streams in a deterministic order
+    inline Rng split() {
+        Rng child(*this);
+        jump();
+        return child;
+    }
+
+
+    // uniform float in [0, 1) from the top 24 bits
+    inline float uniform01() {
+        return static_cast<float>((*this)() >> 40) * (1.f / 16777216.f);
+    }
+
+
+    const State& getState() const { return m_s; }
+    void setState(const State& s) { m_s = s; }
+};
+
+
+#endif //GEOWARS_RNG_H
@@ -0,0 +1,238 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#include "Snapshot.h"
+#include "Entity.h"
+#include "EntityManager.h"
+#include "MappedFile.h"
+#include "Log.h"
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <vector>
+
+namespace {
+    const char          MAGIC[4] = {'G', 'W', 'S', 'N'};
+    const std::uint32_t VERSION{2};   // 2: rng state is raw xoshiro256** words
+
+    std::uint64_t align8(std::uint64_t n) {
+        return (n + 7) & ~std::uint64_t(7);
+    }
+}
+
+
+SnapshotEntity packEntity(const Entity &e, std::uint32_t tagIndex) {
+    SnapshotEntity rec{};
+    rec.id = e.getId();
+    rec.tag = tagIndex;
+
+    if (e.hasComponent<CTransform>()) {
+        auto& t = e.getComponent<CTransform>();
+        rec.components |= SnapTransform;
+        rec.posX = t.pos.x;
+        rec.posY = t.pos.y;
+        rec.velX = t.vel.x;
+        rec.velY = t.vel.y;
+        rec.rot = t.rot;
+        rec.rotSpeed = t.rotSpeed;
+    }
+    if (e.hasComponent<CShape>()) {
+        auto& s = e.getComponent<CShape>();
+        auto& c = s.circle;
+        rec.components |= SnapShape;
+        rec.shapeRadius = c.getRadius();
+        rec.outlineThickness = s.thickness;
+        rec.pointCount = static_cast<std::uint32_t>(s.points);
+        auto f = c.getFillColor();
+        auto o = c.getOutlineColor();
+        rec.fill[0] = f.r; rec.fill[1] = f.g; rec.fill[2] = f.b; rec.fill[3] = f.a;
+        rec.outline[0] = o.r; rec.outline[1] = o.g; rec.outline[2] = o.b; rec.outline[3] = o.a;
+    }
+    if (e.hasComponent<CInput>()) {
+        auto& in = e.getComponent<CInput>();
+        rec.components |= SnapInput;
+        rec.input = (in.up ? 1u : 0u) | (in.left ? 2u : 0u) | (in.right ? 4u : 0u) | (in.down ? 8u : 0u);
+    }
+    if (e.hasComponent<CCollision>()) {
+        rec.components |= SnapCollision;
+        rec.collisionRadius = e.getComponent<CCollision>().radius;
+    }
+    if (e.hasComponent<CScore>()) {
+        rec.components |= SnapScore;
+        rec.score = e.getComponent<CScore>().score;
+    }
+    if (e.hasComponent<CLifespan>()) {
+        auto& l = e.getComponent<CLifespan>();
+        rec.components |= SnapLifespan;
+        rec.lifeTotalUs = l.total.asMicroseconds();
+        rec.lifeRemainingUs = l.remaining.asMicroseconds();
+    }
+    return rec;
+}
+
+
+void unpackEntity(const SnapshotEntity &rec, Entity &e) {
+    if (rec.components & SnapTransform) {
+        auto& t = e.addComponent<CTransform>(sf::Vector2f(rec.posX, rec.posY), sf::Vector2f(rec.velX, rec.velY), rec.rotSpeed);
+        t.rot = rec.rot;
+    }
+    if (rec.components & SnapShape) {
+        e.addComponent<CShape>(rec.shapeRadius, rec.pointCount,
+                               sf::Color(rec.fill[0], rec.fill[1], rec.fill[2], rec.fill[3]),
+                               sf::Color(rec.outline[0], rec.outline[1], rec.outline[2], rec.outline[3]),
+                               rec.outlineThickness);
+    }
+    if (rec.components & SnapInput) {
+        auto& in = e.addComponent<CInput>();
+        in.up = rec.input & 1u;
+        in.left = rec.input & 2u;
+        in.right = rec.input & 4u;
+        in.down = rec.input & 8u;
+    }
+    if (rec.components & SnapCollision)
+        e.addComponent<CCollision>(rec.collisionRadius);
+    if (rec.components & SnapScore)
+        e.addComponent<CScore>(rec.score);
+    if (rec.components & SnapLifespan) {
+        auto& l = e.addComponent<CLifespan>();
+        l.total = sf::microseconds(rec.lifeTotalUs);
+        l.remaining = sf::microseconds(rec.lifeRemainingUs);
+    }
+}
+
+
+bool saveSnapshot(const std::string &path, EntityManager &manager, const SnapshotGlobals &globals) {
+    // everything that is alive now, including entities that are only pending
+    std::vector<const Entity*> entities;
+    for (auto& e : manager.getEntities())
+        if (e->isActive())
+            entities.push_back(e.get());
+    for (auto& e : manager.getPendingEntities())
+        if (e->isActive())
+            entities.push_back(e.get());
+
+    // tag table first so every offset is known before the single write pass
+    std::map<std::string, std::uint32_t> tagIndex;
+    std::vector<const std::string*> tags;
+    std::uint64_t tagBytes{0};
+    for (auto* e : entities) {
+        if (tagIndex.emplace(e->getTag(), static_cast<std::uint32_t>(tags.size())).second) {
+            tags.push_back(&e->getTag());
+            tagBytes += sizeof(std::uint16_t) + e->getTag().size();
+        }
+    }
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.nextEntityId = manager.getNextId();
+    header.tick = globals.tick;
+    header.entityCount = static_cast<std::uint32_t>(entities.size());
+    header.tagCount = static_cast<std::uint32_t>(tags.size());
+    header.entitiesOffset = align8(sizeof(SnapshotHeader));
+    header.tagsOffset = header.entitiesOffset + entities.size() * sizeof(SnapshotEntity);
+    header.rngOffset = header.tagsOffset + tagBytes;
+    header.rngSize = globals.rngState.size();
+    header.spawnCountdownUs = globals.spawnCountdown.asMicroseconds();
+    header.score = globals.score;
+    header.specialWeaponCount = globals.specialWeaponCount;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        Log::error(LogCategory::Snapshot, "Open snapshot {} for writing failed", path);
+        return false;
+    }
+
+    static const char padding[8]{};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(padding, static_cast<std::streamsize>(header.entitiesOffset - sizeof(header)));
+
+    for (auto* e : entities) {
+        auto rec = packEntity(*e, tagIndex[e->getTag()]);
+        out.write(reinterpret_cast<const char*>(&rec), sizeof(rec));
+    }
+
+    for (auto* tag : tags) {
+        auto len = static_cast<std::uint16_t>(tag->size());
+        out.write(reinterpret_cast<const char*>(&len), sizeof(len));
+        out.write(tag->data(), len);
+    }
+
+    out.write(globals.rngState.data(), static_cast<std::streamsize>(globals.rngState.size()));
+    return static_cast<bool>(out);
+}
+
+
+bool loadSnapshot(const std::string &path, EntityManager &manager, SnapshotGlobals &globals) {
+    MappedFile file;
+    if (!file.open(path)) {
+        Log::error(LogCategory::Snapshot, "Open snapshot {} failed", path);
+        return false;
+    }
+
+    auto* base = file.data();
+    auto size = file.size();
+    if (size < sizeof(SnapshotHeader)) {
+        Log::error(LogCategory::Snapshot, "Snapshot {} is truncated", path);
+        return false;
+    }
+
+    SnapshotHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+        Log::error(LogCategory::Snapshot, "Snapshot {} has an unknown format", path);
+        return false;
+    }
+    // written so that no sum can wrap: every offset is checked against size first
+    if (header.entitiesOffset % 8 != 0 || header.entitiesOffset > size ||
+        header.tagsOffset != header.entitiesOffset + std::uint64_t(header.entityCount) * sizeof(SnapshotEntity) ||
+        header.rngOffset < header.tagsOffset ||
+        header.rngSize > size || header.rngOffset > size - header.rngSize) {
+        Log::error(LogCategory::Snapshot, "Snapshot {} is corrupt", path);
+        return false;
+    }
+
+    // tag table
+    std::vector<std::string> tags;
+    tags.reserve(header.tagCount);
+    auto pos = header.tagsOffset;
+    for (std::uint32_t i = 0; i < header.tagCount; ++i) {
+        std::uint16_t len;
+        if (pos + sizeof(len) > header.rngOffset)
+            break;
+        std::memcpy(&len, base + pos, sizeof(len));
+        pos += sizeof(len);
+        if (pos + len > header.rngOffset)
+            break;
+        tags.emplace_back(reinterpret_cast<const char*>(base + pos), len);
+        pos += len;
+    }
+    if (tags.size() != header.tagCount) {
+        Log::error(LogCategory::Snapshot, "Snapshot {} has a corrupt tag table", path);
+        return false;
+    }
+
+    // records are read in place from the mapping (the offset is 8-byte aligned)
+    auto* records = reinterpret_cast<const SnapshotEntity*>(base + header.entitiesOffset);
+    for (std::uint32_t i = 0; i < header.entityCount; ++i) {
+        if (records[i].tag >= tags.size()) {
+            Log::error(LogCategory::Snapshot, "Snapshot {} has a bad tag index", path);
+            return false;
+        }
+    }
+
+    manager.reset(header.nextEntityId);
+    for (std::uint32_t i = 0; i < header.entityCount; ++i) {
+        auto& rec = records[i];
+        auto e = manager.restoreEntity(rec.id, tags[rec.tag]);
+        unpackEntity(rec, *e);
+    }
+
+    globals.score = header.score;
+    globals.specialWeaponCount = header.specialWeaponCount;
+    globals.spawnCountdown = sf::microseconds(header.spawnCountdownUs);
+    globals.tick = header.tick;
+    globals.rngState.assign(reinterpret_cast<const char*>(base + header.rngOffset), header.rngSize);
+    return true;
+}
@@ -0,0 +1,114 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_SNAPSHOT_H
+#define GEOWARS_SNAPSHOT_H
+
+#include <SFML/System.hpp>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+// forward declarations
+class Entity;
+class EntityManager;
+
+
+// Binary world snapshot, native endianness, layout:
+//   SnapshotHeader
+//   SnapshotEntity[entityCount]     (8-byte aligned, read in place from the mapped file)
+//   tag table                        (uint16 length + chars, per tag)
+//   rng state                        (opaque bytes)
+//
+// All entities and their components are written in one pass; on load the file is
+// memory-mapped and the fixed-size entity records are unpacked straight into the
+// entities' component storage without an intermediate copy.
+
+struct SnapshotHeader
+{
+    char            magic[4];           // "GWSN"
+    std::uint32_t   version;
+    std::uint64_t   nextEntityId;
+    std::uint64_t   tick;
+    std::uint32_t   entityCount;
+    std::uint32_t   tagCount;
+    std::uint64_t   entitiesOffset;
+    std::uint64_t   tagsOffset;
+    std::uint64_t   rngOffset;
+    std::uint64_t   rngSize;
+    std::int64_t    spawnCountdownUs;
+    std::int32_t    score;
+    std::int32_t    specialWeaponCount;
+};
+
+
+// Component bits, one per entry of ComponentTuple
+enum SnapshotComponent : std::uint32_t
+{
+    SnapShape       = 1u << 0,
+    SnapInput       = 1u << 1,
+    SnapCollision   = 1u << 2,
+    SnapTransform   = 1u << 3,
+    SnapLifespan    = 1u << 4,
+    SnapScore       = 1u << 5,
+};
+
+
+struct SnapshotEntity
+{
+    std::uint64_t   id;
+    std::uint32_t   tag;                // index into the tag table
+    std::uint32_t   components;         // SnapshotComponent bits
+
+    // CTransform
+    float           posX, posY, velX, velY, rot, rotSpeed;
+
+    // CShape
+    float           shapeRadius;
+    float           outlineThickness;
+    std::uint32_t   pointCount;
+    std::uint8_t    fill[4];
+    std::uint8_t    outline[4];
+
+    // CInput (up, left, right, down bits)
+    std::uint32_t   input;
+
+    // CCollision
+    float           collisionRadius;
+
+    // CScore
+    std::int32_t    score;
+
+    // CLifespan
+    std::int64_t    lifeTotalUs;
+    std::int64_t    lifeRemainingUs;
+};
+
+static_assert(std::is_trivially_copyable_v<SnapshotHeader>);
+static_assert(std::is_trivially_copyable_v<SnapshotEntity>);
+static_assert(sizeof(SnapshotEntity) % 8 == 0, "records must keep 8-byte alignment");
+
+
+// World state that lives outside the entity manager
+struct SnapshotGlobals
+{
+    int             score{0};
+    int             specialWeaponCount{0};
+    sf::Time        spawnCountdown{sf::Time::Zero};
+    std::uint64_t   tick{0};
+    std::string     rngState;
+};
+
+
+// pack / unpack a single entity's components (also used for in-memory snapshots)
+SnapshotEntity  packEntity(const Entity& e, std::uint32_t tagIndex);
+void            unpackEntity(const SnapshotEntity& rec, Entity& e);
+
+bool            saveSnapshot(const std::string& path, EntityManager& manager, const SnapshotGlobals& globals);
+
+// replaces every entity in the manager, returns false (and leaves the world alone) on a bad file
+bool            loadSnapshot(const std::string& path, EntityManager& manager, SnapshotGlobals& globals);
+
+
+#endif //GEOWARS_SNAPSHOT_H
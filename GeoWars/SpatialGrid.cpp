@@ -0,0 +1,100 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#include "SpatialGrid.h"
+#include <cmath>
+
+
+void SpatialGrid::reset(const sf::FloatRect &bounds, float cellSize) {
+    m_bounds = bounds;
+    m_cellSize = std::max(cellSize, 1.f);
+    m_invCellSize = 1.f / m_cellSize;
+    m_cols = std::max(1, static_cast<int>(std::ceil(bounds.width * m_invCellSize)));
+    m_rows = std::max(1, static_cast<int>(std::ceil(bounds.height * m_invCellSize)));
+    m_cellStart.assign(static_cast<size_t>(m_cols) * m_rows + 1, 0);
+    clear();
+}
+
+
+void SpatialGrid::clear() {
+    m_pending.clear();
+    m_items.clear();
+    std::fill(m_cellStart.begin(), m_cellStart.end(), 0);
+    m_maxRadius = 0.f;
+}
+
+
+int SpatialGrid::cellX(float x) const {
+    // anything outside the world is kept in the border cells
+    return std::clamp(static_cast<int>((x - m_bounds.left) * m_invCellSize), 0, m_cols - 1);
+}
+
+
+int SpatialGrid::cellY(float y) const {
+    return std::clamp(static_cast<int>((y - m_bounds.top) * m_invCellSize), 0, m_rows - 1);
+}
+
+
+void SpatialGrid::insert(std::uint32_t id, sf::Vector2f pos, float radius) {
+    auto cell = static_cast<std::uint32_t>(cellY(pos.y) * m_cols + cellX(pos.x));
+    m_pending.push_back({id, cell});
+    m_maxRadius = std::max(m_maxRadius, radius);
+}
+
+
+void SpatialGrid::build() {
+    // counting sort: histogram, prefix sum, scatter
+    std::fill(m_cellStart.begin(), m_cellStart.end(), 0);
+    for (auto& item : m_pending)
+        ++m_cellStart[item.cell + 1];
+    for (size_t c = 1; c < m_cellStart.size(); ++c)
+        m_cellStart[c] += m_cellStart[c - 1];
+
+    m_items.resize(m_pending.size());
+    // walk the pending list in order so items keep their insertion order within a cell
+    for (auto& item : m_pending)
+        m_items[m_cellStart[item.cell]++] = item.id;
+
+    // scatter advanced every start to the next cell's start, shift back
+    for (size_t c = m_cellStart.size() - 1; c > 0; --c)
+        m_cellStart[c] = m_cellStart[c - 1];
+    m_cellStart[0] = 0;
+
+    m_pending.clear();
+}
+
+
+float SpatialGrid::ringDistance(sf::Vector2f center, int ring) const {
+    if (ring <= 0)
+        return 0.f;
+    // everything in the ring is outside the square of cells the rings inside it cover;
+    // negative when center is outside that square, which never prunes anything
+    float left = m_bounds.left + static_cast<float>(cellX(center.x) - ring + 1) * m_cellSize;
+    float top = m_bounds.top + static_cast<float>(cellY(center.y) - ring + 1) * m_cellSize;
+    float right = left + static_cast<float>(2 * ring - 1) * m_cellSize;
+    float bottom = top + static_cast<float>(2 * ring - 1) * m_cellSize;
+    return std::min(std::min(center.x - left, right - center.x), std::min(center.y - top, bottom - center.y));
+}
+
+
+size_t SpatialGrid::size() const {
+    return m_items.size();
+}
+
+
+float SpatialGrid::getCellSize() const {
+    return m_cellSize;
+}
+
+
+const sf::FloatRect &SpatialGrid::getBounds() const {
+    return m_bounds;
+}
+
+
+MemoryFootprint SpatialGrid::getFootprint() const {
+    return MemoryFootprint{
+        m_pending.size() * sizeof(Item) + m_cellStart.size() * sizeof(std::uint32_t) + m_items.size() * sizeof(std::uint32_t),
+        m_pending.capacity() * sizeof(Item) + m_cellStart.capacity() * sizeof(std::uint32_t) + m_items.capacity() * sizeof(std::uint32_t)};
+}
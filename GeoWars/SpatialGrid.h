@@ -0,0 +1,149 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_SPATIALGRID_H
+#define GEOWARS_SPATIALGRID_H
+
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "MemoryStats.h"
+
+
+// Uniform grid over the world, rebuilt from scratch whenever positions change.
+// Items are bucketed by their centre with a counting sort into one flat array, so a
+// rebuild is O(n) and never allocates once the buffers have reached their size.
+// Queries are conservative (every item whose cell lies in the query area, grown by the
+// largest radius inserted); callers do the exact test.
+class SpatialGrid
+{
+private:
+    struct Item
+    {
+        std::uint32_t   id;
+        std::uint32_t   cell;
+    };
+
+    sf::FloatRect               m_bounds{0.f, 0.f, 0.f, 0.f};
+    float                       m_cellSize{128.f};
+    float                       m_invCellSize{1.f / 128.f};
+    int                         m_cols{1};
+    int                         m_rows{1};
+    float                       m_maxRadius{0.f};
+
+    std::vector<Item>           m_pending;
+    std::vector<std::uint32_t>  m_cellStart;    // m_cols * m_rows + 1 offsets into m_items
+    std::vector<std::uint32_t>  m_items;
+
+    int                         cellX(float x) const;
+    int                         cellY(float y) const;
+
+public:
+    SpatialGrid() = default;
+
+    void                        reset(const sf::FloatRect& bounds, float cellSize);
+    void                        clear();
+    void                        insert(std::uint32_t id, sf::Vector2f pos, float radius);
+    void                        build();
+
+    size_t                      size() const;
+    float                       getCellSize() const;
+    const sf::FloatRect&        getBounds() const;
+    MemoryFootprint             getFootprint() const;
+
+
+    // fn(id) for every item that may overlap the rectangle.
+    // If fn returns bool, returning false stops the query.
+    template<typename Fn>
+    inline void queryRect(const sf::FloatRect& r, Fn&& fn) const {
+        int x0 = cellX(r.left - m_maxRadius);
+        int x1 = cellX(r.left + r.width + m_maxRadius);
+        int y0 = cellY(r.top - m_maxRadius);
+        int y1 = cellY(r.top + r.height + m_maxRadius);
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                if (!visitCell(static_cast<size_t>(y * m_cols + x), fn))
+                    return;
+            }
+        }
+    }
+
+
+    // fn(id) for every item that may overlap the circle, same stopping rule as queryRect.
+    // The cell holding the centre is visited first, so a query that stops early
+    // has seen the closest items.
+    template<typename Fn>
+    inline void queryCircle(sf::Vector2f center, float radius, Fn&& fn) const {
+        int cx = cellX(center.x);
+        int cy = cellY(center.y);
+        auto home = static_cast<size_t>(cy * m_cols + cx);
+        if (!visitCell(home, fn))
+            return;
+
+        int x0 = cellX(center.x - radius - m_maxRadius);
+        int x1 = cellX(center.x + radius + m_maxRadius);
+        int y0 = cellY(center.y - radius - m_maxRadius);
+        int y1 = cellY(center.y + radius + m_maxRadius);
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                auto c = static_cast<size_t>(y * m_cols + x);
+                if (c != home && !visitCell(c, fn))
+                    return;
+            }
+        }
+    }
+
+
+    // fn(id) for every item in the cells exactly ring cells away from the one holding
+    // center, ring 0 being that cell itself. Returns false once the whole ring lies
+    // outside the grid, there is nothing further out to visit.
+    template<typename Fn>
+    inline bool queryRing(sf::Vector2f center, int ring, Fn&& fn) const {
+        int cx = cellX(center.x);
+        int cy = cellY(center.y);
+        int x0 = cx - ring, x1 = cx + ring;
+        int y0 = cy - ring, y1 = cy + ring;
+        if (x0 < 0 && y0 < 0 && x1 >= m_cols && y1 >= m_rows)
+            return false;
+
+        auto visit = [&](int x, int y) { visitCell(static_cast<size_t>(y * m_cols + x), fn); };
+        int left = std::max(x0, 0), right = std::min(x1, m_cols - 1);
+        if (y0 >= 0)
+            for (int x = left; x <= right; ++x) visit(x, y0);
+        if (ring > 0 && y1 < m_rows)
+            for (int x = left; x <= right; ++x) visit(x, y1);
+        int top = std::max(y0 + 1, 0), bottom = std::min(y1 - 1, m_rows - 1);
+        if (x0 >= 0)
+            for (int y = top; y <= bottom; ++y) visit(x0, y);
+        if (ring > 0 && x1 < m_cols)
+            for (int y = top; y <= bottom; ++y) visit(x1, y);
+        return true;
+    }
+
+
+    // lower bound on the distance from center to the centre of any item in ring or
+    // further out; items clamped into the border cells are only further away
+    float ringDistance(sf::Vector2f center, int ring) const;
+
+
+private:
+    template<typename Fn>
+    inline bool visitCell(size_t c, Fn& fn) const {
+        for (auto i = m_cellStart[c]; i < m_cellStart[c + 1]; ++i) {
+            if constexpr (std::is_same_v<std::invoke_result_t<Fn&, std::uint32_t>, bool>) {
+                if (!fn(m_items[i]))
+                    return false;
+            }
+            else {
+                fn(m_items[i]);
+            }
+        }
+        return true;
+    }
+};
+
+
+#endif //GEOWARS_SPATIALGRID_H
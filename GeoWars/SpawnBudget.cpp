@@ -0,0 +1,93 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#include "SpawnBudget.h"
+
+
+void SpawnBudget::setBudget(size_t perTick, size_t maxQueued) {
+    m_perTick = perTick;
+    m_maxQueued = maxQueued;
+}
+
+
+void SpawnBudget::setCap(const std::string &tag, size_t cap) {
+    if (tag == "*")
+        m_totalCap = cap;
+    else
+        m_caps[tag] = TagCap{cap};
+}
+
+
+bool SpawnBudget::underCap(EntityManager &manager, const std::string &tag) {
+    if (m_totalCap != 0 && manager.getEntities().size() + m_totalPending >= m_totalCap)
+        return false;
+
+    auto it = m_caps.find(tag);
+    if (it == m_caps.end())
+        return true;
+    return manager.getEntities(tag).size() + it->second.pending < it->second.cap;
+}
+
+
+bool SpawnBudget::hasBudget() const {
+    return m_perTick == 0 || m_admittedThisTick < m_perTick;
+}
+
+
+void SpawnBudget::admitted(const std::string &tag, Lane lane) {
+    if (lane == Lane::World)
+        ++m_admittedThisTick;
+    ++m_totalPending;
+    if (auto it = m_caps.find(tag); it != m_caps.end())
+        ++it->second.pending;
+    ++m_stats.admitted;
+}
+
+
+void SpawnBudget::beginTick(EntityManager &manager) {
+    // everything admitted last tick was just added by update()
+    m_admittedThisTick = 0;
+    m_totalPending = 0;
+    for (auto& [_, c] : m_caps)
+        c.pending = 0;
+
+    while (!m_queue.empty() && hasBudget()) {
+        auto& r = m_queue.front();
+        if (underCap(manager, r.tag)) {
+            r.init(*manager.addEntity(r.tag));
+            admitted(r.tag, Lane::World);
+        }
+        else {
+            ++m_stats.dropped;
+            Log::debug(LogCategory::Spawn, "{} dropped from the spawn queue, over its cap", r.tag);
+        }
+        m_queue.pop_front();
+    }
+}
+
+
+void SpawnBudget::clear() {
+    m_queue.clear();
+    m_admittedThisTick = 0;
+    m_totalPending = 0;
+    for (auto& [_, c] : m_caps)
+        c.pending = 0;
+}
+
+
+size_t SpawnBudget::getQueued() const {
+    return m_queue.size();
+}
+
+
+const SpawnBudget::Stats &SpawnBudget::getStats() const {
+    return m_stats;
+}
+
+
+MemoryFootprint SpawnBudget::getFootprint() const {
+    // a queued Init that does not fit std::function's small buffer owns a heap copy, not counted
+    size_t bytes = m_queue.size() * sizeof(Request);
+    return MemoryFootprint{bytes, bytes};
+}
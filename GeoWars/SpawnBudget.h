@@ -0,0 +1,109 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_SPAWNBUDGET_H
+#define GEOWARS_SPAWNBUDGET_H
+
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include "CommandBuffer.h"
+#include "EntityManager.h"
+#include "Log.h"
+#include "MemoryStats.h"
+
+
+// Admission control for entity creation. At most perTick entities are created per
+// tick; requests over the budget wait in a FIFO queue and are admitted on later ticks,
+// requests that would push a tag (or the whole world, "*") over its population cap,
+// or that find the queue full, are dropped. This bounds the structural work a single
+// tick can cause, however many spawns the game asks for at once. Spawns in the player
+// lane (shots, the special weapon) are bounded by input already: they only check caps
+// and never wait behind a burst of enemies.
+class SpawnBudget
+{
+public:
+    using Init = CommandBuffer::Init;
+
+    enum class Admission { Admitted, Queued, Dropped };
+    enum class Lane { World, Player };
+
+    struct Stats {
+        size_t      admitted{0};
+        size_t      deferred{0};    // had to wait for a later tick
+        size_t      dropped{0};     // cap reached or queue full
+    };
+
+private:
+    struct Request {
+        std::string     tag;
+        Init            init;
+    };
+
+    struct TagCap {
+        size_t          cap;
+        size_t          pending{0};     // admitted but not yet added by EntityManager::update()
+    };
+
+    size_t                                  m_perTick{0};       // 0 = unlimited
+    size_t                                  m_maxQueued{256};
+    size_t                                  m_totalCap{0};      // 0 = unlimited
+    size_t                                  m_totalPending{0};
+    size_t                                  m_admittedThisTick{0};
+    std::unordered_map<std::string, TagCap> m_caps;
+    std::deque<Request>                     m_queue;
+    Stats                                   m_stats;
+
+    bool                    underCap(EntityManager& manager, const std::string& tag);
+    bool                    hasBudget() const;
+    void                    admitted(const std::string& tag, Lane lane);
+
+public:
+    SpawnBudget() = default;
+
+    void                    setBudget(size_t perTick, size_t maxQueued);
+    void                    setCap(const std::string& tag, size_t cap);
+
+    // call right after EntityManager::update(): resets the budget and admits queued requests
+    void                    beginTick(EntityManager& manager);
+
+    // entity is created now if the budget allows, otherwise queued. init runs when the
+    // entity is created, which for a queued request is a later tick or, if the queued
+    // request is dropped after all, never. init only becomes an Init (and may allocate)
+    // when the request has to be queued
+    template<typename Fn>
+    Admission request(EntityManager& manager, const std::string& tag, Fn&& init, Lane lane = Lane::World) {
+        if (!underCap(manager, tag)) {
+            ++m_stats.dropped;
+            Log::debug(LogCategory::Spawn, "{} dropped, over its cap", tag);
+            return Admission::Dropped;
+        }
+
+        // queued requests go first, so a later request never overtakes a deferred one
+        if (lane == Lane::Player || (m_queue.empty() && hasBudget())) {
+            init(*manager.addEntity(tag));
+            admitted(tag, lane);
+            return Admission::Admitted;
+        }
+
+        if (m_queue.size() >= m_maxQueued) {
+            ++m_stats.dropped;
+            Log::debug(LogCategory::Spawn, "{} dropped, the spawn queue is full", tag);
+            return Admission::Dropped;
+        }
+        m_queue.push_back(Request{tag, Init(std::forward<Fn>(init))});
+        ++m_stats.deferred;
+        return Admission::Queued;
+    }
+
+    // forget queued requests, e.g. when a snapshot replaces the world
+    void                    clear();
+
+    size_t                  getQueued() const;
+    MemoryFootprint         getFootprint() const;
+    const Stats&            getStats() const;
+};
+
+
+#endif //GEOWARS_SPAWNBUDGET_H
@@ -0,0 +1,73 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#include "SpawnScheduler.h"
+#include <algorithm>
+
+SpawnScheduler::~SpawnScheduler() {
+    clear();
+}
+
+
+// std heap functions build a max-heap, so "greater" puts the earliest timer on top
+bool SpawnScheduler::later(const Timer& l, const Timer& r) {
+    if (l.due != r.due)
+        return l.due > r.due;
+    return l.seq > r.seq;
+}
+
+
+void SpawnScheduler::schedule(std::coroutine_handle<> h, std::int64_t due) {
+    m_timers.push_back({due, m_seq++, h});
+    std::push_heap(m_timers.begin(), m_timers.end(), later);
+}
+
+
+SpawnScheduler::Delay SpawnScheduler::wait(sf::Time t) {
+    return Delay{*this, t.asMicroseconds()};
+}
+
+
+void SpawnScheduler::start(SpawnTask task) {
+    std::coroutine_handle<> h = task.m_handle;
+    task.m_handle = nullptr;
+    m_live.insert(h.address());
+    schedule(h, m_now);
+}
+
+
+void SpawnScheduler::advance(sf::Time dt) {
+    std::int64_t target = m_now + dt.asMicroseconds();
+
+    while (!m_timers.empty() && m_timers.front().due <= target) {
+        std::pop_heap(m_timers.begin(), m_timers.end(), later);
+        auto h = m_timers.back().handle;
+
+        // the clock reads the timer's own due time while the task runs, so waits
+        // chain from when they were meant to end rather than from the tick boundary
+        m_now = m_timers.back().due;
+        m_timers.pop_back();
+
+        // the task either waits again (and is back in the heap) or runs to the end
+        h.resume();
+        if (h.done()) {
+            m_live.erase(h.address());
+            h.destroy();
+        }
+    }
+    m_now = target;
+}
+
+
+void SpawnScheduler::clear() {
+    for (auto address : m_live)
+        std::coroutine_handle<>::from_address(address).destroy();
+    m_live.clear();
+    m_timers.clear();
+}
+
+
+sf::Time SpawnScheduler::now() const {
+    return sf::microseconds(m_now);
+}
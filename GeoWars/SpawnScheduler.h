@@ -0,0 +1,101 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_SPAWNSCHEDULER_H
+#define GEOWARS_SPAWNSCHEDULER_H
+
+#include <SFML/System.hpp>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <unordered_set>
+#include <vector>
+
+
+// Coroutine type for spawn scripts (waves, bursts, timed patterns). A task does
+// nothing until it is handed to a SpawnScheduler, which then owns it.
+class SpawnTask
+{
+public:
+    struct promise_type
+    {
+        SpawnTask               get_return_object() { return SpawnTask(Handle::from_promise(*this)); }
+        std::suspend_always     initial_suspend() noexcept { return {}; }
+        std::suspend_always     final_suspend() noexcept { return {}; }
+        void                    return_void() {}
+        void                    unhandled_exception() { std::terminate(); }
+    };
+    using Handle = std::coroutine_handle<promise_type>;
+
+private:
+    friend class SpawnScheduler;
+    Handle      m_handle;
+
+    explicit SpawnTask(Handle h) : m_handle(h) {}
+
+public:
+    SpawnTask(SpawnTask&& other) noexcept : m_handle(other.m_handle) { other.m_handle = nullptr; }
+    SpawnTask(const SpawnTask&) = delete;
+    SpawnTask& operator=(const SpawnTask&) = delete;
+    SpawnTask& operator=(SpawnTask&&) = delete;
+    ~SpawnTask() { if (m_handle) m_handle.destroy(); }
+};
+
+
+// Single timer queue driving every spawn coroutine. Suspended tasks sit in a binary
+// heap keyed by wake-up time, so pending timers cost nothing per tick; advance() only
+// touches the ones that are due, in (time, order scheduled) order. Inside a task now()
+// is the time it was due, so timing does not drift with the tick length.
+class SpawnScheduler
+{
+private:
+    struct Timer
+    {
+        std::int64_t                due;        // microseconds of scheduler time
+        std::uint64_t               seq;        // FIFO among equal due times
+        std::coroutine_handle<>     handle;
+    };
+
+    std::int64_t                                m_now{0};
+    std::uint64_t                               m_seq{0};
+    std::vector<Timer>                          m_timers;   // min-heap
+    std::unordered_set<void*>                   m_live;     // frame addresses of unfinished tasks
+
+    static bool                     later(const Timer& l, const Timer& r);
+    void                            schedule(std::coroutine_handle<> h, std::int64_t due);
+
+public:
+    struct Delay
+    {
+        SpawnScheduler&     scheduler;
+        std::int64_t        us;
+
+        bool                await_ready() const noexcept { return us <= 0; }
+        void                await_suspend(std::coroutine_handle<> h) { scheduler.schedule(h, scheduler.m_now + us); }
+        void                await_resume() const noexcept {}
+    };
+
+    SpawnScheduler() = default;
+    ~SpawnScheduler();
+
+    SpawnScheduler(const SpawnScheduler&) = delete;
+    SpawnScheduler& operator=(const SpawnScheduler&) = delete;
+
+    // co_await scheduler.wait(t) inside a task
+    Delay                           wait(sf::Time t);
+
+    // takes ownership, the task first runs on the next advance()
+    void                            start(SpawnTask task);
+
+    // moves scheduler time on by dt and resumes every task that is due
+    void                            advance(sf::Time dt);
+
+    // destroys every pending task
+    void                            clear();
+
+    sf::Time                        now() const;
+};
+
+
+#endif //GEOWARS_SPAWNSCHEDULER_H
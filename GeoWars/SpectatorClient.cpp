@@ -0,0 +1,90 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#include "SpectatorClient.h"
+#include "Log.h"
+#include <algorithm>
+
+
+bool SpectatorClient::connect(const std::string &host, unsigned short port, bool window) {
+    if (m_socket.connect(host, port, sf::seconds(5.f)) != sf::Socket::Done) {
+        Log::error(LogCategory::Stream, "Could not connect to {}:{}", host, port);
+        return false;
+    }
+    m_socket.setBlocking(false);
+    if (window)
+        m_window.create(sf::VideoMode(1080, 620), "GEX Spectator");
+    return true;
+}
+
+
+const DeltaDecoder &SpectatorClient::getDecoder() const {
+    return m_decoder;
+}
+
+
+bool SpectatorClient::receive() {
+    // read whatever is available, then decode every complete message
+    std::uint8_t chunk[16 * 1024];
+    while (true) {
+        size_t received{0};
+        auto status = m_socket.receive(chunk, sizeof(chunk), received);
+        if (status == sf::Socket::Done) {
+            m_buffer.insert(m_buffer.end(), chunk, chunk + received);
+            continue;
+        }
+        if (status == sf::Socket::NotReady || status == sf::Socket::Partial)
+            break;
+        return false;
+    }
+
+    size_t pos{0};
+    while (m_buffer.size() - pos >= 4) {
+        std::uint32_t len = m_buffer[pos] | (m_buffer[pos + 1] << 8) | (m_buffer[pos + 2] << 16) |
+                            (static_cast<std::uint32_t>(m_buffer[pos + 3]) << 24);
+        if (m_buffer.size() - pos - 4 < len)
+            break;
+        if (!m_decoder.decode(m_buffer.data() + pos + 4, len)) {
+            Log::error(LogCategory::Stream, "Malformed state message");
+            return false;
+        }
+        pos += 4 + len;
+    }
+    m_buffer.erase(m_buffer.begin(), m_buffer.begin() + static_cast<std::ptrdiff_t>(pos));
+    return true;
+}
+
+
+void SpectatorClient::render() {
+    m_window.clear(sf::Color(100, 100, 255));
+
+    // show the whole world, scaled to the window
+    auto world = m_decoder.getWorldSize();
+    if (world.x > 0.f && world.y > 0.f)
+        m_window.setView(sf::View(sf::FloatRect(0.f, 0.f, world.x, world.y)));
+
+    for (auto& [id, remote] : m_decoder.getEntities())
+        m_window.draw(remote.shape);
+    m_window.display();
+}
+
+
+void SpectatorClient::run() {
+    while (m_isRunning && m_window.isOpen()) {
+        sf::Event event;
+        while (m_window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed ||
+                (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Q))
+                m_isRunning = false;
+        }
+
+        if (!receive()) {
+            Log::info(LogCategory::Stream, "Spectator stream closed");
+            m_isRunning = false;
+        }
+        render();
+        sf::sleep(sf::milliseconds(1));
+    }
+    m_window.close();
+}
@@ -0,0 +1,42 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_SPECTATORCLIENT_H
+#define GEOWARS_SPECTATORCLIENT_H
+
+#include <SFML/Graphics.hpp>
+#include <SFML/Network.hpp>
+#include <string>
+#include <vector>
+
+#include "StateStream.h"
+
+
+// Read-only view of a running game: connects to the game's StateServer, rebuilds
+// the world from the delta stream and renders it in its own window.
+class SpectatorClient
+{
+private:
+    sf::RenderWindow            m_window;
+    sf::TcpSocket               m_socket;
+    DeltaDecoder                m_decoder;
+    std::vector<std::uint8_t>   m_buffer;
+    bool                        m_isRunning{true};
+
+    void                        render();
+
+public:
+    SpectatorClient() = default;
+
+    // without a window the client only decodes, run() needs one
+    bool                        connect(const std::string& host, unsigned short port, bool window = true);
+    void                        run();
+
+    // reads and decodes whatever has arrived, false once the stream is closed or broken
+    bool                        receive();
+    const DeltaDecoder&         getDecoder() const;
+};
+
+
+#endif //GEOWARS_SPECTATORCLIENT_H
@@ -0,0 +1,62 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_SPSCQUEUE_H
+#define GEOWARS_SPSCQUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+// The producer only writes m_tail and the consumer only writes m_head, each reads the
+// other's index with acquire ordering, so an element is fully written before the
+// consumer can see it. Capacity is a power of two, push() fails instead of blocking
+// when the queue is full.
+template<typename T, size_t Capacity>
+class SpscQueue
+{
+private:
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+    static constexpr size_t         MASK{Capacity - 1};
+
+    std::array<T, Capacity>         m_items{};
+    alignas(64) std::atomic<size_t> m_head{0};      // next to pop, consumer
+    alignas(64) std::atomic<size_t> m_tail{0};      // next to push, producer
+
+public:
+    // producer side
+    bool push(const T& item) {
+        auto tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == Capacity)
+            return false;
+        m_items[tail & MASK] = item;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer side
+    bool pop(T& item) {
+        auto head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire))
+            return false;
+        item = m_items[head & MASK];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // approximate unless called from one of the two threads with the other idle
+    size_t size() const {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+};
+
+
+#endif //GEOWARS_SPSCQUEUE_H
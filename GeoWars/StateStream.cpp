@@ -0,0 +1,370 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#include "StateStream.h"
+#include "Entity.h"
+#include "Log.h"
+#include <algorithm>
+#include <cmath>
+
+
+void stream::writeVarint(std::vector<std::uint8_t> &out, std::uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(v));
+}
+
+
+void stream::writeSigned(std::vector<std::uint8_t> &out, std::int64_t v) {
+    writeVarint(out, (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63));
+}
+
+
+bool stream::readVarint(const std::uint8_t *&p, const std::uint8_t *end, std::uint64_t &v) {
+    v = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        std::uint8_t b = *p++;
+        v |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+        if (!(b & 0x80))
+            return true;
+    }
+    return false;
+}
+
+
+bool stream::readSigned(const std::uint8_t *&p, const std::uint8_t *end, std::int64_t &v) {
+    std::uint64_t u;
+    if (!readVarint(p, end, u))
+        return false;
+    v = static_cast<std::int64_t>(u >> 1) ^ -static_cast<std::int64_t>(u & 1);
+    return true;
+}
+
+
+std::int32_t stream::quantPos(float v) {
+    return static_cast<std::int32_t>(std::lround(v * POS_SCALE));
+}
+
+
+std::uint16_t stream::quantRot(float deg) {
+    float r = std::fmod(deg, 360.f);
+    if (r < 0.f)
+        r += 360.f;
+    return static_cast<std::uint16_t>(static_cast<std::uint32_t>(r * ROT_SCALE) & 0xffff);
+}
+
+
+namespace {
+    using namespace stream;
+
+    // reserve the length prefix, returns its offset
+    size_t beginMessage(std::vector<std::uint8_t>& out, MessageType type) {
+        size_t at = out.size();
+        out.insert(out.end(), 4, 0);
+        out.push_back(type);
+        return at;
+    }
+
+    void endMessage(std::vector<std::uint8_t>& out, size_t at) {
+        auto len = static_cast<std::uint32_t>(out.size() - at - 4);
+        for (int i = 0; i < 4; ++i)
+            out[at + i] = static_cast<std::uint8_t>(len >> (8 * i));
+    }
+
+    enum UpdateFlags : std::uint8_t { HasX = 1, HasY = 2, HasRot = 4, HasAlpha = 8 };
+}
+
+
+void DeltaEncoder::encodeHello(std::vector<std::uint8_t> &out, sf::Vector2f worldSize) {
+    auto at = beginMessage(out, Hello);
+    writeVarint(out, static_cast<std::uint64_t>(worldSize.x));
+    writeVarint(out, static_cast<std::uint64_t>(worldSize.y));
+    endMessage(out, at);
+}
+
+
+void DeltaEncoder::encodeTick(std::vector<std::uint8_t> &out, std::uint64_t tick, const EntityVec &entities) {
+    ++m_generation;
+    auto at = beginMessage(out, Tick);
+    writeVarint(out, tick);
+
+    // counts come first on the wire, so the records are written to the side first
+    std::uint64_t created{0}, updated{0};
+    std::int64_t lastId{0}, lastUpdatedId{0};
+    auto& createdBytes = m_created;
+    auto& updatedBytes = m_updated;
+    createdBytes.clear();
+    updatedBytes.clear();
+
+    for (auto& e : entities) {
+        if (!e->isActive() || !e->hasComponent<CTransform>() || !e->hasComponent<CShape>())
+            continue;
+
+        auto& tfm = e->getComponent<CTransform>();
+        auto& cs = e->getComponent<CShape>();
+        auto& shape = cs.circle;
+        auto id = static_cast<std::int64_t>(e->getId());
+        std::int32_t x = quantPos(tfm.pos.x), y = quantPos(tfm.pos.y);
+        std::uint16_t rot = quantRot(tfm.rot);
+        std::uint8_t alpha = shape.getFillColor().a;
+
+        auto it = m_sent.find(e->getId());
+        if (it == m_sent.end()) {
+            writeSigned(createdBytes, id - lastId);
+            lastId = id;
+            writeVarint(createdBytes, static_cast<std::uint64_t>(shape.getRadius() * POS_SCALE));
+            // authored detail, spectators pick their own quality
+            writeVarint(createdBytes, cs.points);
+            auto f = shape.getFillColor();
+            auto o = shape.getOutlineColor();
+            createdBytes.insert(createdBytes.end(), {f.r, f.g, f.b, f.a, o.r, o.g, o.b, o.a});
+            writeVarint(createdBytes, static_cast<std::uint64_t>(cs.thickness * POS_SCALE));
+            writeSigned(createdBytes, x);
+            writeSigned(createdBytes, y);
+            writeVarint(createdBytes, rot);
+            m_sent.emplace(e->getId(), Sent{x, y, rot, alpha, m_generation});
+            ++created;
+            continue;
+        }
+
+        auto& s = it->second;
+        s.generation = m_generation;
+        std::uint8_t flags = (x != s.x ? HasX : 0) | (y != s.y ? HasY : 0) |
+                             (rot != s.rot ? HasRot : 0) | (alpha != s.alpha ? HasAlpha : 0);
+        if (flags == 0)
+            continue;
+
+        writeSigned(updatedBytes, id - lastUpdatedId);
+        lastUpdatedId = id;
+        updatedBytes.push_back(flags);
+        if (flags & HasX)
+            writeSigned(updatedBytes, x - s.x);
+        if (flags & HasY)
+            writeSigned(updatedBytes, y - s.y);
+        if (flags & HasRot)
+            writeSigned(updatedBytes, static_cast<std::int16_t>(rot - s.rot));
+        if (flags & HasAlpha)
+            updatedBytes.push_back(alpha);
+        s = Sent{x, y, rot, alpha, m_generation};
+        ++updated;
+    }
+
+    // anything not seen this tick is gone
+    m_destroyed.clear();
+    for (auto it = m_sent.begin(); it != m_sent.end();) {
+        if (it->second.generation != m_generation) {
+            m_destroyed.push_back(it->first);
+            it = m_sent.erase(it);
+        }
+        else
+            ++it;
+    }
+    std::sort(m_destroyed.begin(), m_destroyed.end());
+
+    writeVarint(out, created);
+    out.insert(out.end(), createdBytes.begin(), createdBytes.end());
+
+    writeVarint(out, m_destroyed.size());
+    std::int64_t lastDestroyed{0};
+    for (auto id : m_destroyed) {
+        writeSigned(out, static_cast<std::int64_t>(id) - lastDestroyed);
+        lastDestroyed = static_cast<std::int64_t>(id);
+    }
+
+    writeVarint(out, updated);
+    out.insert(out.end(), updatedBytes.begin(), updatedBytes.end());
+    endMessage(out, at);
+}
+
+
+void DeltaDecoder::place(Remote &r) {
+    // the shape is kept ready to draw, positions are only turned back into pixels here
+    r.shape.setPosition(r.x / POS_SCALE, r.y / POS_SCALE);
+    r.shape.setRotation(r.rot / ROT_SCALE);
+}
+
+
+bool DeltaDecoder::decode(const std::uint8_t *p, size_t size) {
+    const std::uint8_t* end = p + size;
+    if (p == end)
+        return false;
+
+    auto type = *p++;
+    std::uint64_t count;
+    std::int64_t d;
+
+    if (type == Hello) {
+        std::uint64_t w, h;
+        if (!readVarint(p, end, w) || !readVarint(p, end, h))
+            return false;
+        m_worldSize = sf::Vector2f(static_cast<float>(w), static_cast<float>(h));
+        m_entities.clear();
+        return true;
+    }
+    if (type != Tick || !readVarint(p, end, m_tick))
+        return false;
+
+    // created
+    if (!readVarint(p, end, count))
+        return false;
+    std::int64_t id{0};
+    for (std::uint64_t i = 0; i < count; ++i) {
+        std::uint64_t radius, points, thickness, rot;
+        std::int64_t x, y;
+        if (!readSigned(p, end, d) || !readVarint(p, end, radius) || !readVarint(p, end, points) || end - p < 8)
+            return false;
+        id += d;
+        sf::Color fill(p[0], p[1], p[2], p[3]), outline(p[4], p[5], p[6], p[7]);
+        p += 8;
+        if (!readVarint(p, end, thickness) || !readSigned(p, end, x) || !readSigned(p, end, y) || !readVarint(p, end, rot))
+            return false;
+
+        auto& r = m_entities[static_cast<std::uint64_t>(id)];
+        float rad = radius / POS_SCALE;
+        r.shape.setRadius(rad);
+        r.shape.setPointCount(std::max<std::uint64_t>(points, 3));
+        r.shape.setOrigin(rad, rad);
+        r.shape.setFillColor(fill);
+        r.shape.setOutlineColor(outline);
+        r.shape.setOutlineThickness(thickness / POS_SCALE);
+        r.x = static_cast<std::int32_t>(x);
+        r.y = static_cast<std::int32_t>(y);
+        r.rot = static_cast<std::uint16_t>(rot);
+        place(r);
+    }
+
+    // destroyed
+    if (!readVarint(p, end, count))
+        return false;
+    id = 0;
+    for (std::uint64_t i = 0; i < count; ++i) {
+        if (!readSigned(p, end, d))
+            return false;
+        id += d;
+        m_entities.erase(static_cast<std::uint64_t>(id));
+    }
+
+    // updated
+    if (!readVarint(p, end, count))
+        return false;
+    id = 0;
+    for (std::uint64_t i = 0; i < count; ++i) {
+        if (!readSigned(p, end, d) || p == end)
+            return false;
+        id += d;
+        std::uint8_t flags = *p++;
+        auto it = m_entities.find(static_cast<std::uint64_t>(id));
+        Remote scratch;
+        auto& r = (it != m_entities.end()) ? it->second : scratch;
+        if ((flags & HasX) && !readSigned(p, end, d)) return false;
+        if (flags & HasX) r.x += static_cast<std::int32_t>(d);
+        if ((flags & HasY) && !readSigned(p, end, d)) return false;
+        if (flags & HasY) r.y += static_cast<std::int32_t>(d);
+        if ((flags & HasRot) && !readSigned(p, end, d)) return false;
+        if (flags & HasRot) r.rot = static_cast<std::uint16_t>(r.rot + d);
+        if (flags & HasAlpha) {
+            if (p == end)
+                return false;
+            auto c = r.shape.getFillColor();
+            c.a = *p++;
+            r.shape.setFillColor(c);
+        }
+        if (flags & (HasX | HasY | HasRot))
+            place(r);
+    }
+    return p == end;
+}
+
+
+const std::unordered_map<std::uint64_t, DeltaDecoder::Remote> &DeltaDecoder::getEntities() const {
+    return m_entities;
+}
+
+
+sf::Vector2f DeltaDecoder::getWorldSize() const {
+    return m_worldSize;
+}
+
+
+std::uint64_t DeltaDecoder::getTick() const {
+    return m_tick;
+}
+
+
+bool StateServer::start(unsigned short port, sf::Vector2f worldSize) {
+    m_worldSize = worldSize;
+    if (m_listener.listen(port, sf::IpAddress::LocalHost) != sf::Socket::Done) {
+        Log::error(LogCategory::Stream, "State stream could not listen on port {}", port);
+        return false;
+    }
+    m_listener.setBlocking(false);
+    m_listening = true;
+    Log::info(LogCategory::Stream, "State stream listening on localhost:{}", port);
+    return true;
+}
+
+
+bool StateServer::flush(Client &c) {
+    while (!c.pending.empty()) {
+        size_t sent{0};
+        auto status = c.socket->send(c.pending.data(), c.pending.size(), sent);
+        c.pending.erase(c.pending.begin(), c.pending.begin() + static_cast<std::ptrdiff_t>(sent));
+        m_bytesSent += sent;
+        if (status == sf::Socket::Done)
+            continue;
+        if (status == sf::Socket::Partial || status == sf::Socket::NotReady)
+            return true;
+        return false;   // disconnected or error
+    }
+    return true;
+}
+
+
+void StateServer::accept(std::uint64_t tick, const EntityVec &entities) {
+    if (!m_listening)
+        return;
+
+    // any spectator that connected since the last call gets the whole world as of tick;
+    // called between ticks, setting up a client allocates. The spare socket is only
+    // replaced once a client took it, so polling with nobody connecting does not
+    while (true) {
+        if (!m_spare)
+            m_spare = std::make_unique<sf::TcpSocket>();
+        if (m_listener.accept(*m_spare) != sf::Socket::Done)
+            break;
+        m_spare->setBlocking(false);
+        Client c;
+        c.socket = std::move(m_spare);
+        c.encoder.encodeHello(c.pending, m_worldSize);
+        c.encoder.encodeTick(c.pending, tick, entities);
+        if (flush(c))
+            m_clients.push_back(std::move(c));
+    }
+}
+
+
+void StateServer::publish(std::uint64_t tick, const EntityVec &entities) {
+    if (!m_listening)
+        return;
+
+    for (auto& c : m_clients)
+        c.encoder.encodeTick(c.pending, tick, entities);
+
+    // drop clients that disconnected or fell too far behind (they can reconnect)
+    m_clients.erase(std::remove_if(m_clients.begin(), m_clients.end(), [this](Client& c) {
+        return !flush(c) || c.pending.size() > MAX_BACKLOG;
+    }), m_clients.end());
+}
+
+
+size_t StateServer::getClientCount() const {
+    return m_clients.size();
+}
+
+
+std::uint64_t StateServer::getBytesSent() const {
+    return m_bytesSent;
+}
@@ -0,0 +1,131 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_STATESTREAM_H
+#define GEOWARS_STATESTREAM_H
+
+#include <SFML/Graphics.hpp>
+#include <SFML/Network.hpp>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "EntityManager.h"
+
+
+// Wire format (all integers LEB128 varints, signed ones zigzag encoded):
+//   message  := u32 length (little endian) , type , body
+//   Hello    := type 1, worldWidth, worldHeight
+//   Tick     := type 2, tick, created, destroyed, updated
+//   created  := count, { idDelta, radius, points, fill rgba, outline rgba, thickness, x, y, rot }
+//   destroyed:= count, { idDelta }
+//   updated  := count, { idDelta, flags, [dx], [dy], [drot], [alpha] }
+// Positions are quantised to 1/8 pixel, rotation to 1/65536 of a turn, and updates
+// only carry the fields that changed since the last message sent to that client.
+
+namespace stream {
+    enum MessageType : std::uint8_t { Hello = 1, Tick = 2 };
+
+    const float POS_SCALE{8.f};
+    const float ROT_SCALE{65536.f / 360.f};
+
+    void            writeVarint(std::vector<std::uint8_t>& out, std::uint64_t v);
+    void            writeSigned(std::vector<std::uint8_t>& out, std::int64_t v);
+    bool            readVarint(const std::uint8_t*& p, const std::uint8_t* end, std::uint64_t& v);
+    bool            readSigned(const std::uint8_t*& p, const std::uint8_t* end, std::int64_t& v);
+
+    // world values as they go over the wire
+    std::int32_t    quantPos(float v);
+    std::uint16_t   quantRot(float deg);
+}
+
+
+// Encodes per-tick deltas for one receiver, remembering what it has already been sent.
+class DeltaEncoder
+{
+private:
+    struct Sent
+    {
+        std::int32_t    x, y;
+        std::uint16_t   rot;
+        std::uint8_t    alpha;
+        std::uint32_t   generation;
+    };
+
+    std::unordered_map<std::uint64_t, Sent>     m_sent;
+    std::uint32_t                               m_generation{0};
+    std::vector<std::uint64_t>                  m_destroyed;
+    std::vector<std::uint8_t>                   m_created;      // record scratch, reused per tick
+    std::vector<std::uint8_t>                   m_updated;
+
+public:
+    void    encodeHello(std::vector<std::uint8_t>& out, sf::Vector2f worldSize);
+    void    encodeTick(std::vector<std::uint8_t>& out, std::uint64_t tick, const EntityVec& entities);
+};
+
+
+// Rebuilds the world on the receiving side.
+class DeltaDecoder
+{
+public:
+    struct Remote
+    {
+        sf::CircleShape     shape;          // positioned and rotated, ready to draw
+        std::int32_t        x, y;
+        std::uint16_t       rot;
+    };
+
+private:
+    std::unordered_map<std::uint64_t, Remote>   m_entities;
+    sf::Vector2f                                m_worldSize{0.f, 0.f};
+    std::uint64_t                               m_tick{0};
+
+    static void                                 place(Remote& r);
+
+public:
+    // one message body (without the length prefix), false if malformed
+    bool                                                decode(const std::uint8_t* data, size_t size);
+
+    const std::unordered_map<std::uint64_t, Remote>&    getEntities() const;
+    sf::Vector2f                                        getWorldSize() const;
+    std::uint64_t                                       getTick() const;
+};
+
+
+// Non-blocking localhost TCP server that streams deltas to any number of spectators.
+class StateServer
+{
+private:
+    struct Client
+    {
+        std::unique_ptr<sf::TcpSocket>  socket;
+        DeltaEncoder                    encoder;
+        std::vector<std::uint8_t>       pending;    // bytes not yet accepted by the socket
+    };
+
+    static const size_t                 MAX_BACKLOG{4 * 1024 * 1024};
+
+    sf::TcpListener                     m_listener;
+    std::vector<Client>                 m_clients;
+    std::unique_ptr<sf::TcpSocket>      m_spare;        // accepts the next spectator
+    sf::Vector2f                        m_worldSize;
+    bool                                m_listening{false};
+    std::uint64_t                       m_bytesSent{0};
+
+    bool                                flush(Client& c);
+
+public:
+    bool                                start(unsigned short port, sf::Vector2f worldSize);
+    // new spectators start from the world as it is, call between ticks
+    void                                accept(std::uint64_t tick, const EntityVec& entities);
+    // what changed this tick to every spectator
+    void                                publish(std::uint64_t tick, const EntityVec& entities);
+
+    size_t                              getClientCount() const;
+    std::uint64_t                       getBytesSent() const;
+};
+
+
+#endif //GEOWARS_STATESTREAM_H
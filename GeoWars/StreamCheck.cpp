@@ -0,0 +1,88 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#include "StreamCheck.h"
+#include "Game.h"
+#include "Log.h"
+#include "SpectatorClient.h"
+#include "StateStream.h"
+
+namespace {
+    // what the spectator should hold for this world, false on the first difference
+    bool matches(const EntityVec& entities, const DeltaDecoder& decoder, std::uint64_t tick) {
+        auto& remote = decoder.getEntities();
+        size_t streamed{0};
+        for (auto& e : entities) {
+            if (!e->isActive() || !e->hasComponent<CTransform>() || !e->hasComponent<CShape>())
+                continue;
+            ++streamed;
+            auto it = remote.find(e->getId());
+            if (it == remote.end()) {
+                Log::error(LogCategory::Stream, "tick {}: entity {} ({}) missing on the spectator", tick, e->getId(), e->getTag());
+                return false;
+            }
+            auto& tfm = e->getComponent<CTransform>();
+            auto& r = it->second;
+            if (r.x != stream::quantPos(tfm.pos.x) || r.y != stream::quantPos(tfm.pos.y) || r.rot != stream::quantRot(tfm.rot)
+                || r.shape.getFillColor().a != e->getComponent<CShape>().circle.getFillColor().a) {
+                Log::error(LogCategory::Stream, "tick {}: entity {} ({}) differs on the spectator", tick, e->getId(), e->getTag());
+                return false;
+            }
+        }
+        if (streamed != remote.size()) {
+            Log::error(LogCategory::Stream, "tick {}: spectator has {} entities, the world {}", tick, remote.size(), streamed);
+            return false;
+        }
+        return true;
+    }
+
+    // the client is non-blocking, poll until it has decoded tick or the stream stalls
+    bool waitFor(SpectatorClient& client, std::uint64_t tick) {
+        sf::Clock clock;
+        while (client.getDecoder().getTick() != tick) {
+            if (!client.receive() || clock.getElapsedTime() > sf::seconds(2.f))
+                return false;
+            sf::sleep(sf::milliseconds(1));
+        }
+        return true;
+    }
+}
+
+
+bool checkStreamRoundTrip(const std::string &configPath, std::uint64_t ticks, unsigned short port) {
+    Game game(configPath, true);
+    game.runHeadless(1);
+
+    // the check only compares entities, the world size in the hello does not matter
+    StateServer server;
+    if (!server.start(port, sf::Vector2f()))
+        return false;
+    SpectatorClient client;
+    if (!client.connect("127.0.0.1", port, false))
+        return false;
+
+    // the spectator joins a world that is already running and starts from a full copy
+    server.accept(game.getTick(), game.getEntities());
+    if (server.getClientCount() != 1 || !waitFor(client, game.getTick())) {
+        Log::error(LogCategory::Stream, "the spectator never received the world");
+        return false;
+    }
+
+    for (std::uint64_t i = 0; i < ticks; ++i) {
+        if (!matches(game.getEntities(), client.getDecoder(), game.getTick()))
+            return false;
+        game.runHeadless(1);
+        server.publish(game.getTick(), game.getEntities());
+        if (!waitFor(client, game.getTick())) {
+            Log::error(LogCategory::Stream, "tick {} never reached the spectator", game.getTick());
+            return false;
+        }
+    }
+    if (!matches(game.getEntities(), client.getDecoder(), game.getTick()))
+        return false;
+
+    Log::info(LogCategory::Stream, "Stream round trip: {} ticks, {} bytes, every tick matched",
+              ticks, server.getBytesSent());
+    return true;
+}
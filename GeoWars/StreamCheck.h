@@ -0,0 +1,20 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_STREAMCHECK_H
+#define GEOWARS_STREAMCHECK_H
+
+#include <cstdint>
+#include <string>
+
+
+// Both ends of the state stream in one process, over localhost: a headless world feeds
+// a StateServer, a SpectatorClient without a window decodes what arrives, and after
+// every tick the decoded entities must be exactly the world's (same ids, and positions,
+// rotations and fill alpha as quantised for the wire). Logs the first mismatch and
+// returns false.
+bool checkStreamRoundTrip(const std::string& configPath, std::uint64_t ticks, unsigned short port);
+
+
+#endif //GEOWARS_STREAMCHECK_H
@@ -0,0 +1,73 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#include "Swarm.h"
+#include "JobSystem.h"
+#include "SpatialGrid.h"
+#include <cmath>
+
+namespace {
+    const size_t GRAIN{128};
+
+    // v scaled to length len (zero stays zero)
+    sf::Vector2f withLength(sf::Vector2f v, float len) {
+        float l2 = v.x * v.x + v.y * v.y;
+        if (l2 <= 0.f)
+            return v;
+        return v * (len / std::sqrt(l2));
+    }
+
+    sf::Vector2f limit(sf::Vector2f v, float max) {
+        float l2 = v.x * v.x + v.y * v.y;
+        if (l2 <= max * max)
+            return v;
+        return v * (max / std::sqrt(l2));
+    }
+
+    // Reynolds steering: the desired velocity minus the current one, clamped
+    sf::Vector2f steerTowards(sf::Vector2f desired, sf::Vector2f vel, const SwarmParams& p) {
+        return limit(withLength(desired, p.maxSpeed) - vel, p.maxForce);
+    }
+}
+
+
+void steerSwarm(JobSystem &jobs, const SpatialGrid &grid, const SwarmParams &params,
+                const std::pmr::vector<SwarmAgent> &agents, sf::Vector2f target,
+                std::pmr::vector<sf::Vector2f> &steer) {
+    steer.resize(agents.size());
+    const float r2 = params.radius * params.radius;
+
+    jobs.parallelFor(agents.size(), GRAIN, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i) {
+            const auto& self = agents[i];
+            sf::Vector2f separation, alignment, centre;
+            size_t seen = 0;
+
+            // stops after maxNeighbours, a dense cluster costs no more than a sparse one
+            grid.queryCircle(self.pos, params.radius, [&](std::uint32_t j) {
+                if (j == i)
+                    return true;
+                const auto& other = agents[j];
+                sf::Vector2f d = self.pos - other.pos;
+                float d2 = d.x * d.x + d.y * d.y;
+                if (d2 >= r2 || d2 <= 0.f)
+                    return true;
+
+                separation += d / d2;       // closer neighbours push harder
+                alignment += other.vel;
+                centre += other.pos;
+                return ++seen < params.maxNeighbours;
+            });
+
+            sf::Vector2f force = params.seek * steerTowards(target - self.pos, self.vel, params);
+            if (seen > 0) {
+                float inv = 1.f / static_cast<float>(seen);
+                force += params.separation * steerTowards(separation, self.vel, params);
+                force += params.alignment * steerTowards(alignment * inv, self.vel, params);
+                force += params.cohesion * steerTowards(centre * inv - self.pos, self.vel, params);
+            }
+            steer[i] = force;
+        }
+    });
+}
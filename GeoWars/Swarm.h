@@ -0,0 +1,50 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_SWARM_H
+#define GEOWARS_SWARM_H
+
+#include <SFML/System.hpp>
+#include <memory_resource>
+#include <vector>
+
+// forward declarations
+class JobSystem;
+class SpatialGrid;
+
+
+// Boids steering weights and limits, distances in world units, speeds per second
+struct SwarmParams
+{
+    float   radius{ 80.f };         // neighbours closer than this are seen
+    float   maxSpeed{ 250.f };
+    float   maxForce{ 400.f };      // steering acceleration limit
+    float   separation{ 1.5f };
+    float   alignment{ 1.f };
+    float   cohesion{ 1.f };
+    float   seek{ 0.8f };           // pull towards the target (the player)
+    size_t  maxNeighbours{ 16 };    // the rest of a dense cluster is ignored
+};
+
+
+struct SwarmAgent
+{
+    sf::Vector2f    pos;
+    sf::Vector2f    vel;
+};
+
+
+// Computes the steering acceleration of every agent from its neighbours
+// (separation, alignment, cohesion) and a seek towards target.
+// grid must hold every agent, keyed by its index in agents. Each agent looks at no more
+// than maxNeighbours others, nearest cell first, so the cost stays linear in the number
+// of agents however tightly they bunch up. Agents are processed in parallel; each one
+// only reads agents and writes its own steer entry, so the result does not depend on
+// the number of threads.
+void steerSwarm(JobSystem& jobs, const SpatialGrid& grid, const SwarmParams& params,
+                const std::pmr::vector<SwarmAgent>& agents, sf::Vector2f target,
+                std::pmr::vector<sf::Vector2f>& steer);
+
+
+#endif //GEOWARS_SWARM_H
@@ -0,0 +1,105 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#include "TargetIndex.h"
+#include "JobSystem.h"
+
+namespace {
+    const size_t GRAIN{128};
+
+    bool closer(const TargetHit& l, const TargetHit& r) {
+        return l.dist2 < r.dist2 || (l.dist2 == r.dist2 && l.index < r.index);
+    }
+}
+
+
+void TargetIndex::reset(const sf::FloatRect &bounds, float cellSize) {
+    m_grid.reset(bounds, cellSize);
+    m_positions.clear();
+}
+
+
+void TargetIndex::clear() {
+    m_grid.clear();
+    m_positions.clear();
+}
+
+
+std::uint32_t TargetIndex::add(sf::Vector2f pos) {
+    auto index = static_cast<std::uint32_t>(m_positions.size());
+    m_positions.push_back(pos);
+    m_grid.insert(index, pos, 0.f);
+    return index;
+}
+
+
+void TargetIndex::build() {
+    m_grid.build();
+}
+
+
+size_t TargetIndex::size() const {
+    return m_positions.size();
+}
+
+
+sf::Vector2f TargetIndex::getPosition(std::uint32_t index) const {
+    return m_positions[index];
+}
+
+
+MemoryFootprint TargetIndex::getFootprint() const {
+    MemoryFootprint bytes{m_positions.size() * sizeof(sf::Vector2f), m_positions.capacity() * sizeof(sf::Vector2f)};
+    bytes += m_grid.getFootprint();
+    return bytes;
+}
+
+
+TargetHit TargetIndex::nearest(sf::Vector2f pos, float maxDistance) const {
+    TargetHit hit;
+    kNearest(pos, 1, maxDistance, &hit);
+    return hit;
+}
+
+
+size_t TargetIndex::kNearest(sf::Vector2f pos, size_t k, float maxDistance, TargetHit *out) const {
+    if (k == 0 || m_positions.empty())
+        return 0;
+
+    const float limit2 = maxDistance * maxDistance;
+    size_t count = 0;
+    auto consider = [&](std::uint32_t index) {
+        sf::Vector2f d = m_positions[index] - pos;
+        TargetHit hit{index, d.x * d.x + d.y * d.y};
+        if (hit.dist2 > limit2 || (count == k && !closer(hit, out[k - 1])))
+            return;
+        // out is kept sorted, k is small so an insertion beats a heap
+        size_t i = count < k ? count++ : k - 1;
+        for (; i > 0 && closer(hit, out[i - 1]); --i)
+            out[i] = out[i - 1];
+        out[i] = hit;
+    };
+
+    for (int ring = 0; ; ++ring) {
+        // nothing in this ring or beyond can beat the worst hit kept so far
+        float bound = m_grid.ringDistance(pos, ring);
+        float worst2 = count == k ? out[k - 1].dist2 : limit2;
+        if (bound > 0.f && bound * bound > worst2)
+            break;
+        if (!m_grid.queryRing(pos, ring, consider))
+            break;
+    }
+    return count;
+}
+
+
+void TargetIndex::nearestBatch(JobSystem &jobs, const std::pmr::vector<sf::Vector2f> &points,
+                               float maxDistance, std::pmr::vector<TargetHit> &hits) const {
+    hits.resize(points.size());
+    // every query only reads the index and writes its own entry
+    jobs.parallelFor(points.size(), GRAIN, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; ++i)
+            hits[i] = nearest(points[i], maxDistance);
+    });
+}
@@ -0,0 +1,67 @@
+//
+// Created by Aurelio Rodrigues on 2026-10-18.
+//
+
+#ifndef GEOWARS_TARGETINDEX_H
+#define GEOWARS_TARGETINDEX_H
+
+#include <SFML/System.hpp>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <vector>
+#include "MemoryStats.h"
+#include "SpatialGrid.h"
+
+// forward declarations
+class JobSystem;
+
+
+// One result of a nearest query: the target's index (the order targets were added in)
+// and its squared distance from the query point
+struct TargetHit
+{
+    static constexpr std::uint32_t NONE{std::numeric_limits<std::uint32_t>::max()};
+
+    std::uint32_t   index{NONE};
+    float           dist2{0.f};
+};
+
+
+// Points that can be aimed at (the live enemies), rebuilt once per tick, answering
+// "which targets are nearest to here". A query searches the grid ring by ring outwards
+// from the cell holding the point and stops as soon as the next ring cannot hold
+// anything closer than what it already has, so it looks at a few cells whatever the
+// number of targets. Distances are between centres; equal distances go to the lower index.
+class TargetIndex
+{
+private:
+    SpatialGrid                 m_grid;
+    std::vector<sf::Vector2f>   m_positions;
+
+public:
+    TargetIndex() = default;
+
+    void                        reset(const sf::FloatRect& bounds, float cellSize);
+    void                        clear();
+    std::uint32_t               add(sf::Vector2f pos);
+    void                        build();
+
+    size_t                      size() const;
+    sf::Vector2f                getPosition(std::uint32_t index) const;
+    MemoryFootprint             getFootprint() const;
+
+    // the closest target no further than maxDistance, hit.index is NONE if there is none
+    TargetHit                   nearest(sf::Vector2f pos, float maxDistance) const;
+
+    // up to k targets no further than maxDistance, closest first; returns how many were
+    // written to out, which must have room for k
+    size_t                      kNearest(sf::Vector2f pos, size_t k, float maxDistance, TargetHit* out) const;
+
+    // nearest() for every point, spread over the job system; hits[i] answers points[i]
+    void                        nearestBatch(JobSystem& jobs, const std::pmr::vector<sf::Vector2f>& points,
+                                             float maxDistance, std::pmr::vector<TargetHit>& hits) const;
+};
+
+
+#endif //GEOWARS_TARGETINDEX_H
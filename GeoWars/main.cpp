@@ -11,16 +11,52 @@
 
 
 #include <iostream>
+#include <string>
+#include <thread>
 
 #include "Game.h"
+#include "SpectatorClient.h"
+#include "BatchRunner.h"
+#include "StreamCheck.h"
 
 #include "Utilities.h"
 #include <SFML/System.hpp>
 #include <SFML/Graphics.hpp>
 
-int main() {
+// usage: GeoWars [snapshot]                 start from a saved world snapshot
+//        GeoWars --spectate [port] [host]   watch a running game (StreamPort in config.txt)
+//        GeoWars --batch [worlds] [ticks]   run headless worlds in parallel and report ticks/sec
+//        GeoWars --stream-check [ticks] [port]   stream a headless world to a spectator
+//                                           on localhost and check every tick arrives intact
+int main(int argc, char* argv[]) {
+
+	if (argc > 1 && std::string(argv[1]) == "--batch") {
+		size_t worlds = argc > 2 ? std::stoul(argv[2]) : std::thread::hardware_concurrency();
+		uint64_t ticks = argc > 3 ? std::stoull(argv[3]) : 3600;
+		BatchRunner runner("../config.txt", worlds, ticks);
+		runner.run();
+		return 0;
+	}
+
+	if (argc > 1 && std::string(argv[1]) == "--stream-check") {
+		uint64_t ticks = argc > 2 ? std::stoull(argv[2]) : 600;
+		unsigned short port = argc > 3 ? static_cast<unsigned short>(std::stoi(argv[3])) : 53001;
+		return checkStreamRoundTrip("../config.txt", ticks, port) ? 0 : 1;
+	}
+
+	if (argc > 1 && std::string(argv[1]) == "--spectate") {
+		unsigned short port = argc > 2 ? static_cast<unsigned short>(std::stoi(argv[2])) : 53000;
+		std::string host = argc > 3 ? argv[3] : "127.0.0.1";
+		SpectatorClient spectator;
+		if (!spectator.connect(host, port))
+			return 1;
+		spectator.run();
+		return 0;
+	}
 
 	Game game("../config.txt");
+	if (argc > 1 && !game.loadSnapshot(argv[1]))
+		return 1;
 	game.run();
 	return 0;
 }